@@ -38,6 +38,11 @@ def main():
         action="store_true",
         help="Build with PALLOC_SINGLE_THREADED (no-op mutexes, non-atomic counters)",
     )
+    parser.add_argument(
+        "--header-only",
+        action="store_true",
+        help="Build palloc as a header-only INTERFACE library (PALLOC_HEADER_ONLY)",
+    )
     parser.add_argument(
         "--static", action="store_true", help="Link libraries statically"
     )
@@ -102,6 +107,7 @@ def main():
         f"-DPALLOC_BUILD_STRESS_TESTS={'ON' if args.stress_test else 'OFF'}",
         f"-DPALLOC_STATIC_LINKING={'ON' if args.static else 'OFF'}",
         f"-DPALLOC_SINGLE_THREADED={'ON' if args.single_threaded else 'OFF'}",
+        f"-DPALLOC_HEADER_ONLY={'ON' if args.header_only else 'OFF'}",
     ]
 
     if args.asan:
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "page_source.h"
 #include "palloc_atomic.h"
 #include "platform.h"
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <new>
+#include <type_traits>
+#include <utility>
 
 #ifndef PALLOC_DEFAULT_ALIGNMENT
 #ifdef PALLOC_8BYTE_ALIGNMENT
@@ -17,15 +21,19 @@
 
 namespace AL
 {
-template<size_t Talignment = PALLOC_DEFAULT_ALIGNMENT>
+template<size_t Talignment = PALLOC_DEFAULT_ALIGNMENT, page_source Tsource = platform_mem>
 class arena
 {
 public:
-    explicit arena(size_t bytes) : memory(nullptr), used(0), capacity(0)
+    // flags control how the backing pages are mapped (see mem_flags).
+    // source provides the region (see page_source.h)
+    explicit arena(size_t bytes, mem_flags flags = mem_flags::none, Tsource source = Tsource{})
+        : memory(nullptr), used(0), capacity(0), m_source(std::move(source))
     {
-        size_t page_size = AL::platform_mem::page_size();
-        capacity = ((bytes + page_size - 1) / page_size) * page_size;
-        void* ptr = AL::platform_mem::alloc(capacity);
+        // the bump pointer is shared lock-free, so there is no single place to commit from. commit eagerly.
+        flags = flags & ~mem_flags::lazy_commit;
+        capacity = source_round_size(m_source, bytes, flags);
+        void* ptr = m_source.alloc(capacity, flags);
         if (ptr == nullptr)
         {
             throw std::bad_alloc();
@@ -37,14 +45,15 @@ public:
     {
         if (memory != nullptr)
         {
-            AL::platform_mem::free(memory, capacity);
+            m_source.free(memory, capacity);
         }
     }
 
     arena(const arena&) = delete;
     arena& operator=(const arena&) = delete;
 
-    arena(arena&& other) noexcept : memory(other.memory), used(other.used.load(std::memory_order_relaxed)), capacity(other.capacity)
+    arena(arena&& other) noexcept
+        : memory(other.memory), used(other.used.load(std::memory_order_relaxed)), capacity(other.capacity), m_source(std::move(other.m_source))
     {
         other.memory = nullptr;
         other.used.store(0, std::memory_order_relaxed);
@@ -57,11 +66,12 @@ public:
         {
             if (memory != nullptr)
             {
-                AL::platform_mem::free(memory, capacity);
+                m_source.free(memory, capacity);
             }
             memory = other.memory;
             used.store(other.used.load(std::memory_order_relaxed), std::memory_order_relaxed);
             capacity = other.capacity;
+            m_source = std::move(other.m_source);
             other.memory = nullptr;
             other.used.store(0, std::memory_order_relaxed);
             other.capacity = 0;
@@ -97,6 +107,33 @@ public:
         return ptr;
     }
 
+    // grows the most recent allocation in place: ptr and old_length must be what the last alloc() returned and was
+    // asked for. returns true if [ptr, ptr + new_length) now belongs to the caller, always the case when the padding
+    // already covers it. false if something was allocated since, the arena is full or another thread got in between
+    // (then nothing changed, copy to a new allocation instead)
+    [[nodiscard]] bool try_extend(void* ptr, size_t old_length, size_t new_length)
+    {
+        if (ptr == nullptr || memory == nullptr)
+            return false;
+        auto* block = static_cast<std::byte*>(ptr);
+        if (block < memory || block >= memory + capacity)
+            return false;
+
+        size_t old_total = (old_length + Talignment - 1) & ~(Talignment - 1);
+        size_t new_total = (new_length + Talignment - 1) & ~(Talignment - 1);
+        if (new_total < new_length)
+            return false;
+        if (new_total <= old_total)
+            return true;
+
+        size_t offset = static_cast<size_t>(block - memory);
+        if (new_total > capacity - offset)
+            return false;
+
+        size_t expected = offset + old_total;
+        return used.compare_exchange_strong(expected, offset + new_total, std::memory_order_relaxed);
+    }
+
     int reset()
     {
         used.store(0, std::memory_order_relaxed);
@@ -107,7 +144,7 @@ public:
     {
         if (memory != nullptr)
         {
-            bool ok = AL::platform_mem::free(memory, capacity);
+            bool ok = m_source.free(memory, capacity);
             memory = nullptr;
             if (!ok)
                 return -1;
@@ -122,14 +159,138 @@ public:
         return used.load(std::memory_order::relaxed);
     }
 
+    // bytes of the region currently backed by huge pages (see mem_flags::huge_pages)
+    size_t get_huge_page_bytes() const
+    {
+        return AL::platform_mem::huge_page_bytes(memory, capacity);
+    }
+
     size_t get_capacity() const
     {
         return capacity;
     }
 
+    Tsource& get_source() noexcept
+    {
+        return m_source;
+    }
+
 private:
     std::byte* memory;
     palloc_atomic<size_t> used;
     size_t capacity;
+    [[no_unique_address]] Tsource m_source;
+};
+
+// growable array of trivially copyable T inside an arena, e.g. a string builder.
+// while it is the arena's most recent allocation it grows in place with try_extend(). otherwise it moves to a
+// larger allocation and the old one is abandoned until the arena resets. the arena must outlive the buffer
+template<typename T, typename Tarena = arena<>>
+class arena_buffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "elements are moved with memcpy");
+
+public:
+    explicit arena_buffer(Tarena& a) noexcept : m_arena(&a)
+    {}
+
+    arena_buffer(const arena_buffer&) = delete;
+    arena_buffer& operator=(const arena_buffer&) = delete;
+
+    // returns: false if the arena is out of space, the contents are unchanged then
+    [[nodiscard]] bool reserve(size_t count)
+    {
+        if (count <= m_capacity)
+            return true;
+        if (count > SIZE_MAX / sizeof(T))
+            return false;
+
+        // doubling keeps the copies amortized O(1) when extending fails
+        size_t grown = m_capacity > SIZE_MAX / sizeof(T) / 2 ? count : m_capacity * 2;
+        size_t target = grown > count ? grown : count;
+        if (m_data != nullptr)
+        {
+            if (m_arena->try_extend(m_data, m_capacity * sizeof(T), target * sizeof(T)))
+            {
+                m_capacity = target;
+                return true;
+            }
+            if (target != count && m_arena->try_extend(m_data, m_capacity * sizeof(T), count * sizeof(T)))
+            {
+                m_capacity = count;
+                return true;
+            }
+        }
+
+        void* ptr = m_arena->alloc(target * sizeof(T));
+        if (ptr == nullptr)
+        {
+            target = count;
+            ptr = m_arena->alloc(target * sizeof(T));
+            if (ptr == nullptr)
+                return false;
+        }
+        if (m_size != 0)
+            std::memcpy(ptr, m_data, m_size * sizeof(T));
+        m_data = static_cast<T*>(ptr);
+        m_capacity = target;
+        return true;
+    }
+
+    [[nodiscard]] bool push_back(const T& value)
+    {
+        if (m_size == m_capacity && !reserve(m_size + 1))
+            return false;
+        m_data[m_size++] = value;
+        return true;
+    }
+
+    [[nodiscard]] bool append(const T* values, size_t count)
+    {
+        if (count == 0)
+            return true;
+        if (count > SIZE_MAX - m_size || !reserve(m_size + count))
+            return false;
+        std::memcpy(m_data + m_size, values, count * sizeof(T));
+        m_size += count;
+        return true;
+    }
+
+    // keeps the capacity
+    void clear() noexcept
+    {
+        m_size = 0;
+    }
+
+    T* data() noexcept
+    {
+        return m_data;
+    }
+    const T* data() const noexcept
+    {
+        return m_data;
+    }
+    T& operator[](size_t index) noexcept
+    {
+        return m_data[index];
+    }
+    const T& operator[](size_t index) const noexcept
+    {
+        return m_data[index];
+    }
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+private:
+    Tarena* m_arena;
+    T* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
 };
 } // namespace AL
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "dynamic_slab.h"
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace AL
+{
+
+// serves coroutine frames. the compiler knows every frame size and frames mostly die in LIFO order, so:
+//   1. a per-thread recycler keeps a small stack of frames for each of the first Trecycled_sizes frame sizes the
+//      thread frees. in a pipeline those are the hot coroutines, and a pop is a compare and a load
+//   2. everything else goes through one process-wide dynamic_slab (which has its own per-thread caches)
+//   3. frames larger than the largest size class fall back to the global heap
+// frames may be freed on a different thread than the one that allocated them. size classes are aligned to their
+// size, so every frame of 16 bytes or more meets the default new alignment.
+template<typename Tconfig = slab_config<>, size_t Trecycled_sizes = 4, size_t Trecycle_depth = 32>
+class frame_allocator
+{
+public:
+    static constexpr size_t MAX_FRAME_SIZE = Tconfig::SIZE_CLASS_CONFIG[Tconfig::NUM_SIZE_CLASSES - 1].byte_size;
+
+    // returns: nullptr if failed, else the frame
+    [[nodiscard]] static void* alloc(size_t size)
+    {
+        if (size > MAX_FRAME_SIZE)
+            return ::operator new(size, std::nothrow);
+
+        if (void* frame = local().pop(size))
+            return frame;
+        return backing().palloc(size);
+    }
+
+    // size must be the size the frame was allocated with
+    static void free(void* ptr, size_t size)
+    {
+        if (ptr == nullptr)
+            return;
+        if (size > MAX_FRAME_SIZE)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        if (!local().push(ptr, size))
+            backing().free(ptr, size);
+    }
+
+    // the slab behind every frame. never destroyed, so frames outliving static destruction stay valid
+    static dynamic_slab<Tconfig>& backing()
+    {
+        static dynamic_slab<Tconfig>* instance = new dynamic_slab<Tconfig>();
+        return *instance;
+    }
+
+private:
+    struct recycler
+    {
+        struct slot
+        {
+            size_t size = 0; // 0 means unclaimed
+            size_t count = 0;
+            std::array<void*, Trecycle_depth> frames;
+        };
+
+        std::array<slot, Trecycled_sizes> slots{};
+
+        void* pop(size_t size)
+        {
+            for (slot& s : slots)
+            {
+                if (s.size == size)
+                    return s.count != 0 ? s.frames[--s.count] : nullptr;
+            }
+            return nullptr;
+        }
+
+        // claims an unclaimed slot for a new size. sizes that miss every slot go to the slab
+        bool push(void* ptr, size_t size)
+        {
+            for (slot& s : slots)
+            {
+                if (s.size == 0)
+                    s.size = size;
+                if (s.size == size)
+                {
+                    if (s.count == Trecycle_depth)
+                        return false;
+                    s.frames[s.count++] = ptr;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // the frames go back through this thread's slab cache, which nothing flushes once the thread is gone
+        ~recycler()
+        {
+            for (slot& s : slots)
+            {
+                while (s.count != 0)
+                    backing().free(s.frames[--s.count], s.size);
+            }
+            backing().release_warm();
+        }
+    };
+
+    static recycler& local()
+    {
+        thread_local recycler instance;
+        return instance;
+    }
+};
+
+using default_frame_allocator = frame_allocator<>;
+
+// promise mixin: derive a promise_type from this and its coroutine frames come from Tallocator
+//
+//   struct task::promise_type : AL::frame_promise<> { ... };
+template<typename Tallocator = default_frame_allocator>
+struct frame_promise
+{
+    static void* operator new(std::size_t size)
+    {
+        void* frame = Tallocator::alloc(size);
+        if (frame == nullptr)
+            throw std::bad_alloc();
+        return frame;
+    }
+
+    static void operator delete(void* ptr, std::size_t size) noexcept
+    {
+        Tallocator::free(ptr, size);
+    }
+};
+
+} // namespace AL
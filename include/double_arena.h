@@ -0,0 +1,193 @@
+#pragma once
+
+#include "arena.h"
+#include "page_source.h"
+#include "platform.h"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace AL
+{
+
+// one region, two stacks: the front grows up and the back grows down, so long-lived results and temporary scratch
+// share a single budget. it runs out only when the two ends meet. each end has its own savepoints and reset.
+// not thread safe: meant for one owner, e.g. a query running its build phase from the back and keeping the
+// results at the front
+//
+//   size_t mark = a.back_mark();
+//   void* tmp = a.alloc_back(n);   // scratch for this phase
+//   void* out = a.alloc_front(m);  // kept
+//   a.rewind_back(mark);
+template<size_t Talignment = PALLOC_DEFAULT_ALIGNMENT, page_source Tsource = platform_mem>
+class double_arena
+{
+    static_assert((Talignment & (Talignment - 1)) == 0, "alignment must be a power of two");
+
+public:
+    explicit double_arena(size_t bytes, mem_flags flags = mem_flags::none, Tsource source = Tsource{})
+        : memory(nullptr), front(0), back(0), capacity(0), m_source(std::move(source))
+    {
+        // both ends move, there is no single place to commit from. commit eagerly.
+        flags = flags & ~mem_flags::lazy_commit;
+        capacity = source_round_size(m_source, bytes, flags);
+        void* ptr = m_source.alloc(capacity, flags);
+        if (ptr == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        memory = static_cast<std::byte*>(ptr);
+        back = capacity;
+    }
+
+    ~double_arena()
+    {
+        if (memory != nullptr)
+        {
+            m_source.free(memory, capacity);
+        }
+    }
+
+    double_arena(const double_arena&) = delete;
+    double_arena& operator=(const double_arena&) = delete;
+
+    double_arena(double_arena&& other) noexcept
+        : memory(std::exchange(other.memory, nullptr)), front(std::exchange(other.front, 0)), back(std::exchange(other.back, 0)),
+          capacity(std::exchange(other.capacity, 0)), m_source(std::move(other.m_source))
+    {}
+
+    double_arena& operator=(double_arena&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (memory != nullptr)
+            {
+                m_source.free(memory, capacity);
+            }
+            memory = std::exchange(other.memory, nullptr);
+            front = std::exchange(other.front, 0);
+            back = std::exchange(other.back, 0);
+            capacity = std::exchange(other.capacity, 0);
+            m_source = std::move(other.m_source);
+        }
+        return *this;
+    }
+
+    // returns: nullptr if length is 0 or the ends would cross
+    [[nodiscard]] void* alloc_front(size_t length)
+    {
+        size_t total_to_add = round(length);
+        if (length == 0 || total_to_add < length || total_to_add > back - front)
+            return nullptr;
+
+        void* ptr = memory + front;
+        front += total_to_add;
+        return ptr;
+    }
+
+    // returns: nullptr if length is 0 or the ends would cross
+    [[nodiscard]] void* alloc_back(size_t length)
+    {
+        size_t total_to_add = round(length);
+        if (length == 0 || total_to_add < length || total_to_add > back - front)
+            return nullptr;
+
+        back -= total_to_add;
+        return memory + back;
+    }
+
+    [[nodiscard]] void* calloc_front(size_t length)
+    {
+        void* ptr = alloc_front(length);
+        if (ptr != nullptr)
+        {
+            std::memset(ptr, 0, length);
+        }
+        return ptr;
+    }
+
+    [[nodiscard]] void* calloc_back(size_t length)
+    {
+        void* ptr = alloc_back(length);
+        if (ptr != nullptr)
+        {
+            std::memset(ptr, 0, length);
+        }
+        return ptr;
+    }
+
+    // savepoints: the bytes in use at one end. rewinding frees everything that end allocated since the mark,
+    // the other end is untouched. marks past the current position are ignored
+    size_t front_mark() const
+    {
+        return front;
+    }
+    size_t back_mark() const
+    {
+        return capacity - back;
+    }
+    void rewind_front(size_t mark)
+    {
+        if (mark <= front)
+            front = mark;
+    }
+    void rewind_back(size_t mark)
+    {
+        if (mark <= capacity - back)
+            back = capacity - mark;
+    }
+
+    void reset_front()
+    {
+        front = 0;
+    }
+    void reset_back()
+    {
+        back = capacity;
+    }
+    void reset()
+    {
+        front = 0;
+        back = capacity;
+    }
+
+    size_t get_front_used() const
+    {
+        return front;
+    }
+    size_t get_back_used() const
+    {
+        return capacity - back;
+    }
+
+    // bytes left between the two ends
+    size_t get_free() const
+    {
+        return back - front;
+    }
+
+    size_t get_capacity() const
+    {
+        return capacity;
+    }
+
+    Tsource& get_source() noexcept
+    {
+        return m_source;
+    }
+
+private:
+    static constexpr size_t round(size_t length)
+    {
+        return (length + Talignment - 1) & ~(Talignment - 1);
+    }
+
+    std::byte* memory;
+    size_t front; // offset of the first free byte
+    size_t back;  // offset of the last allocation from the back, capacity when empty
+    size_t capacity;
+    [[no_unique_address]] Tsource m_source;
+};
+
+} // namespace AL
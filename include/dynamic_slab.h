@@ -1,22 +1,61 @@
 #pragma once
 
+#include "page_source.h"
 #include "palloc_atomic.h"
 #include "platform.h"
 #include "radix_tree.h"
 #include "slab.h"
+#include <array>
+#include <concepts>
 #include <cstddef>
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <utility>
 
 namespace AL
 {
 
-template<typename Tconfig>
+// allocation hint for dynamic_slab::palloc. each lifetime draws from its own set of slabs, so short-lived churn never
+// shares a slab with objects that stay: the short-lived slabs empty out completely for shrink(), and long-lived and
+// permanent objects pack densely in theirs
+enum class lifetime : uint8_t
+{
+    short_lived, // the default, used by every call without a hint
+    long_lived,
+    permanent
+};
+
+// which slab dynamic_slab::palloc takes a block from
+enum class placement : uint8_t
+{
+    // newest slab first. the cheapest, but live objects spread over every slab
+    newest_first,
+    // the fullest slab that still has blocks of the class, so lightly used slabs drain for shrink(). each class
+    // sticks to its chosen slab until that runs dry, only then the slabs are scanned again
+    fullest_first
+};
+
+template<typename Tconfig, page_source Tsource = platform_mem>
 class dynamic_slab
 {
 public:
-    explicit dynamic_slab();
+    // flags apply to every slab region mapped by this allocator, including later growth.
+    // source provides node and slab regions (see page_source.h), every slab draws from this one source
+    explicit dynamic_slab(mem_flags flags = mem_flags::none, Tsource source = Tsource{});
+
+    // nested: every node and slab is carved from a caller-provided buffer or a parent arena, with no mmap/munmap.
+    // growth fails once that memory is used up. the memory goes back with the buffer / arena.
+    dynamic_slab(void* buffer, size_t size, mem_flags flags = mem_flags::none)
+        requires std::same_as<Tsource, region_source>
+        : dynamic_slab(flags, region_source(buffer, size))
+    {}
+
+    template<size_t Talignment, page_source Tarena_source>
+    explicit dynamic_slab(arena<Talignment, Tarena_source>& parent, mem_flags flags = mem_flags::none)
+        requires std::same_as<Tsource, arena_source<arena<Talignment, Tarena_source>>>
+        : dynamic_slab(flags, arena_source(parent))
+    {}
 
     // WARNING: this destructor only cleans up the current thread's thread local caches (TLC).
     // if other threads have allocated from this dynamic_slab, their TLC
@@ -33,20 +72,56 @@ public:
     // returns memory is properly aligned
     [[nodiscard]] void* palloc(size_t size);
 
+    // same, from the slabs kept for objects of this lifetime. free() needs no hint
+    [[nodiscard]] void* palloc(size_t size, lifetime hint);
+
+    // compile-time size, see slab::alloc<Tsize>(). only growth falls back to palloc(size), and fullest_first
+    // placement always takes palloc(size)
+    template<size_t Tsize>
+    [[nodiscard]] void* palloc();
+
     // returns: nullptr if failed, else memory address (zeroed)
     // returns memory is properly aligned
     [[nodiscard]] void* calloc(size_t size);
+    [[nodiscard]] void* calloc(size_t size, lifetime hint);
 
     // free pointer allocated by this dynamic_slab
     void free(void* ptr, size_t size);
 
+    // compile-time size, see slab::free<Tsize>()
+    template<size_t Tsize>
+    void free(void* ptr);
+
+    // allocates up to n blocks of `size` into out[], filling from each slab in turn with slab::alloc_bulk (in the order
+    // the placement picks them) and growing once the existing slabs run dry. returns the number allocated
+    [[nodiscard]] size_t alloc_bulk(size_t size, size_t n, void* out[]);
+
+    // frees n blocks of `size`. runs of pointers owned by the same slab go to it in one slab::free_bulk call.
+    // nullptr and foreign pointers are skipped
+    void free_bulk(size_t size, void* const ptrs[], size_t n);
+
+    // defers the free in this thread's buffer, tagged with the owning slab, see slab::free_deferred
+    void free_deferred(void* ptr, size_t size);
+
+    // drains this thread's deferred frees into every slab, see slab::drain
+    void drain();
+
+    // grows until the short-lived slabs have per_class_counts[i] free blocks of each class between them, then prewarms them
+    // from the head down, the order palloc() tries them in (see slab::prewarm).
+    // returns the number of blocks covered, < the sum of counts only if growth failed
+    size_t prewarm(const std::array<size_t, Tconfig::NUM_SIZE_CLASSES>& per_class_counts);
+
+    // returns this thread's cached blocks in every slab, see slab::release_warm.
+    // slabs that prewarm() grew stay mapped until shrink()
+    void release_warm();
+
     // free pointer allocated by this dynamic_slab without knowing the size.
     // returns true if pointer was owned by this allocator, false otherwise.
     bool free_unsized(void* ptr);
 
     // reclaim empty slab pages back to the OS.
     // NOT thread-safe - caller must ensure no concurrent alloc/free operations.
-    // keeps the head slab alive even if empty.
+    // keeps the head slab of each lifetime alive even if empty.
     // returns: number of slabs reclaimed
     size_t shrink();
 
@@ -56,39 +131,140 @@ public:
     // the dynamic_slab remains usable — next palloc() will allocate a fresh slab.
     void purge();
 
+    // opt-in placement policy, newest_first by default. set it before allocating from several threads
+    void set_placement(placement policy) noexcept
+    {
+        m_placement = policy;
+    }
+    placement get_placement() const noexcept
+    {
+        return m_placement;
+    }
+
     size_t get_total_capacity() const;
     size_t get_total_free() const;
     size_t get_slab_count() const;
+    // slabs serving one lifetime
+    size_t get_slab_count(lifetime hint) const;
+    // bytes of all slab regions currently backed by huge pages (see mem_flags::huge_pages)
+    size_t get_huge_page_bytes() const;
+
+    Tsource& get_source() noexcept
+    {
+        return m_source;
+    }
 
 private:
+    using node_slab = slab<Tconfig, shared_source_t<Tsource>>;
+
     struct slab_node
     {
-        slab<Tconfig> value;
+        node_slab value;
         slab_node* next;
 
-        slab_node(slab_node* next_ptr) : value(), next(next_ptr)
+        slab_node(slab_node* next_ptr, mem_flags flags, shared_source_t<Tsource> source) : value(flags, std::move(source)), next(next_ptr)
         {}
     };
 
+    static constexpr size_t NUM_LIFETIMES = 3;
+
+    // palloc (Tzero = false) / calloc (Tzero = true) over every slab of one lifetime, growing when they are all full
+    template<bool Tzero>
+    void* alloc_or_grow(size_t size, lifetime hint);
+
+    // fullest_first: allocates from the class's preferred slab, choosing a new one when it runs dry.
+    // returns nullptr when no slab has a block left, palloc then grows as usual
+    template<bool Tzero>
+    void* alloc_fullest(size_t size, lifetime hint);
+    // fullest_first for alloc_bulk: fills from the preferred slab, then from each newly chosen one.
+    // returns the number allocated, alloc_bulk grows for the rest
+    size_t alloc_bulk_fullest(size_t index, size_t size, size_t n, void* out[]);
+    // scans for the fullest slab that still has blocks of the class and makes it the preferred one.
+    // returns nullptr if none has
+    slab_node* choose_fullest(size_t index, lifetime hint);
+
+    // forgets every preferred slab, after slabs were unmapped
+    void clear_preferred()
+    {
+        for (auto& per_class : m_preferred)
+        {
+            for (palloc_atomic<slab_node*>& node : per_class)
+                node.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    palloc_atomic<slab_node*>& head_of(lifetime hint)
+    {
+        return heads[static_cast<size_t>(hint)];
+    }
+
+    // every node of every lifetime
+    template<typename Tfn>
+    void for_each_node(Tfn&& fn) const
+    {
+        for (const palloc_atomic<slab_node*>& head : heads)
+        {
+            for (slab_node* node = head.load(std::memory_order_acquire); node; node = node->next)
+                fn(node);
+        }
+    }
+
+    template<bool Tzero>
+    static void* node_alloc(node_slab& value, size_t size)
+    {
+        if constexpr (Tzero)
+            return value.calloc(size);
+        else
+            return value.alloc(size);
+    }
+
     // allocate and construct a new slab_node via mmap
     slab_node* create_node(slab_node* next_ptr);
+    // destroy a node and return its header to the source
+    void destroy_node(slab_node* node);
+
+    // the node header is written immediately, only the slab region inside it may be lazily committed.
+    // it is far smaller than a huge page, so huge page flags only apply to the slab region too
+    mem_flags node_flags() const
+    {
+        return m_flags & ~(mem_flags::lazy_commit | mem_flags::huge_pages | mem_flags::huge_tlb);
+    }
+    // where node headers are mapped: the source's base_source if it only adds flags (e.g. huge_page_source),
+    // which would otherwise be applied to the header as well
+    decltype(auto) header_source()
+    {
+        if constexpr (requires { typename Tsource::base_source; })
+            return typename Tsource::base_source{};
+        else
+            return (m_source);
+    }
+    size_t node_bytes()
+    {
+        auto&& source = header_source();
+        return source_round_size(source, sizeof(slab_node), node_flags());
+    }
 
-    palloc_atomic<slab_node*> head;
+    std::array<palloc_atomic<slab_node*>, NUM_LIFETIMES> heads; // one list of slabs per lifetime
     palloc_atomic<size_t> node_count;
+    // fullest_first's current slab for each lifetime and class
+    std::array<std::array<palloc_atomic<slab_node*>, Tconfig::NUM_SIZE_CLASSES>, NUM_LIFETIMES> m_preferred;
+    placement m_placement = placement::newest_first;
     pool_mutex grow_mutex; // only held when adding a new slab
     radix_tree m_tree;
+    mem_flags m_flags;
+    [[no_unique_address]] Tsource m_source;
 };
 
-template<typename Tconfig>
-typename dynamic_slab<Tconfig>::slab_node* dynamic_slab<Tconfig>::create_node(slab_node* next_ptr)
+template<typename Tconfig, page_source Tsource>
+typename dynamic_slab<Tconfig, Tsource>::slab_node* dynamic_slab<Tconfig, Tsource>::create_node(slab_node* next_ptr)
 {
-    void* mem = AL::platform_mem::alloc(sizeof(slab_node));
+    void* mem = header_source().alloc(node_bytes(), node_flags());
     if (mem == nullptr)
         return nullptr;
 
     try
     {
-        auto* node = std::construct_at(static_cast<slab_node*>(mem), next_ptr);
+        auto* node = std::construct_at(static_cast<slab_node*>(mem), next_ptr, m_flags, share_source(m_source));
 
         // register the slab's contiguous pool region as a single range
         m_tree.insert(static_cast<void*>(node->value.region_start()), static_cast<void*>(node->value.region_end()), reinterpret_cast<size_t>(node));
@@ -97,44 +273,79 @@ typename dynamic_slab<Tconfig>::slab_node* dynamic_slab<Tconfig>::create_node(sl
     }
     catch (...)
     {
-        AL::platform_mem::free(mem, sizeof(slab_node));
+        header_source().free(mem, node_bytes());
         return nullptr;
     }
 }
 
-template<typename Tconfig>
-dynamic_slab<Tconfig>::dynamic_slab() : head(nullptr), node_count(0)
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::destroy_node(slab_node* node)
+{
+    node->~slab_node();
+    header_source().free(node, node_bytes());
+}
+
+template<typename Tconfig, page_source Tsource>
+dynamic_slab<Tconfig, Tsource>::dynamic_slab(mem_flags flags, Tsource source)
+    : node_count(0), m_flags(flags), m_source(std::move(source))
 {
+    for (palloc_atomic<slab_node*>& head : heads)
+        head.store(nullptr, std::memory_order_relaxed);
+    clear_preferred();
+
+    // the other lifetimes get their first slab on their first allocation
     slab_node* node = create_node(nullptr);
     if (node)
     {
-        head.store(node, std::memory_order_release);
+        head_of(lifetime::short_lived).store(node, std::memory_order_release);
         node_count.store(1, std::memory_order_relaxed);
     }
 }
 
-template<typename Tconfig>
-dynamic_slab<Tconfig>::~dynamic_slab()
+template<typename Tconfig, page_source Tsource>
+dynamic_slab<Tconfig, Tsource>::~dynamic_slab()
 {
-    slab_node* current = head.load(std::memory_order_acquire);
-    while (current)
+    for (palloc_atomic<slab_node*>& head : heads)
     {
-        slab_node* next = current->next;
-        current->~slab_node();
-        AL::platform_mem::free(current, sizeof(slab_node));
-        current = next;
+        slab_node* current = head.load(std::memory_order_acquire);
+        while (current)
+        {
+            slab_node* next = current->next;
+            destroy_node(current);
+            current = next;
+        }
     }
 }
 
-template<typename Tconfig>
-void* dynamic_slab<Tconfig>::palloc(size_t size)
+template<typename Tconfig, page_source Tsource>
+void* dynamic_slab<Tconfig, Tsource>::palloc(size_t size)
+{
+    return alloc_or_grow<false>(size, lifetime::short_lived);
+}
+
+template<typename Tconfig, page_source Tsource>
+void* dynamic_slab<Tconfig, Tsource>::palloc(size_t size, lifetime hint)
+{
+    return alloc_or_grow<false>(size, hint);
+}
+
+template<typename Tconfig, page_source Tsource>
+template<bool Tzero>
+void* dynamic_slab<Tconfig, Tsource>::alloc_or_grow(size_t size, lifetime hint)
 {
     if (size == 0 || size == static_cast<size_t>(-1))
         return nullptr;
 
+    palloc_atomic<slab_node*>& head = head_of(hint);
+
+    if (m_placement == placement::fullest_first)
+    {
+        if (void* p = alloc_fullest<Tzero>(size, hint))
+            return p;
+    }
     for (slab_node* node = head.load(std::memory_order_acquire); node; node = node->next)
     {
-        void* p = node->value.alloc(size);
+        void* p = node_alloc<Tzero>(node->value, size);
         if (p)
             return p;
     }
@@ -145,7 +356,7 @@ void* dynamic_slab<Tconfig>::palloc(size_t size)
     // double check if another thread may have grown while we waited
     for (slab_node* node = head.load(std::memory_order_relaxed); node; node = node->next)
     {
-        void* p = node->value.alloc(size);
+        void* p = node_alloc<Tzero>(node->value, size);
         if (p)
             return p;
     }
@@ -157,24 +368,84 @@ void* dynamic_slab<Tconfig>::palloc(size_t size)
     head.store(new_node, std::memory_order_release);
     node_count.fetch_add(1, std::memory_order_relaxed);
 
-    return new_node->value.alloc(size);
+    return node_alloc<Tzero>(new_node->value, size);
+}
+
+template<typename Tconfig, page_source Tsource>
+template<bool Tzero>
+void* dynamic_slab<Tconfig, Tsource>::alloc_fullest(size_t size, lifetime hint)
+{
+    const size_t index = node_slab::size_to_index(size);
+    if (index == static_cast<size_t>(-1))
+        return nullptr;
+
+    if (slab_node* node = m_preferred[static_cast<size_t>(hint)][index].load(std::memory_order_acquire))
+    {
+        if (void* p = node_alloc<Tzero>(node->value, size))
+            return p;
+    }
+
+    slab_node* fullest = choose_fullest(index, hint);
+    if (fullest == nullptr)
+        return nullptr;
+    return node_alloc<Tzero>(fullest->value, size);
+}
+
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::alloc_bulk_fullest(size_t index, size_t size, size_t n, void* out[])
+{
+    size_t done = 0;
+    if (slab_node* node = m_preferred[static_cast<size_t>(lifetime::short_lived)][index].load(std::memory_order_acquire))
+        done = node->value.alloc_bulk(size, n, out);
+
+    while (done < n)
+    {
+        slab_node* node = choose_fullest(index, lifetime::short_lived);
+        if (node == nullptr)
+            break;
+        const size_t got = node->value.alloc_bulk(size, n - done, out + done);
+        if (got == 0)
+            break; // another thread emptied it first, let alloc_bulk grow
+        done += got;
+    }
+    return done;
 }
 
-template<typename Tconfig>
-void* dynamic_slab<Tconfig>::calloc(size_t size)
+template<typename Tconfig, page_source Tsource>
+typename dynamic_slab<Tconfig, Tsource>::slab_node* dynamic_slab<Tconfig, Tsource>::choose_fullest(size_t index, lifetime hint)
 {
-    void* ptr = palloc(size);
-    if (ptr)
+    // the fewest free blocks of this class, but not none. every slab of a class has the same block size
+    slab_node* fullest = nullptr;
+    size_t fullest_free = static_cast<size_t>(-1);
+    for (slab_node* node = head_of(hint).load(std::memory_order_acquire); node; node = node->next)
     {
-        size_t index = slab<Tconfig>::size_to_index(size);
-        if (index != static_cast<size_t>(-1) && index < Tconfig::NUM_SIZE_CLASSES)
-            std::memset(ptr, 0, slab<Tconfig>::index_to_size_class(index));
+        const size_t available = node->value.get_pool_free_space(index);
+        if (available != 0 && available < fullest_free)
+        {
+            fullest = node;
+            fullest_free = available;
+        }
     }
-    return ptr;
+    if (fullest != nullptr)
+        m_preferred[static_cast<size_t>(hint)][index].store(fullest, std::memory_order_release);
+    return fullest;
+}
+
+template<typename Tconfig, page_source Tsource>
+void* dynamic_slab<Tconfig, Tsource>::calloc(size_t size)
+{
+    // each slab's calloc skips zeroing blocks it has never handed out
+    return alloc_or_grow<true>(size, lifetime::short_lived);
+}
+
+template<typename Tconfig, page_source Tsource>
+void* dynamic_slab<Tconfig, Tsource>::calloc(size_t size, lifetime hint)
+{
+    return alloc_or_grow<true>(size, hint);
 }
 
-template<typename Tconfig>
-void dynamic_slab<Tconfig>::free(void* ptr, size_t size)
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::free(void* ptr, size_t size)
 {
     if (ptr == nullptr || size == 0 || size == static_cast<size_t>(-1))
         return;
@@ -186,106 +457,318 @@ void dynamic_slab<Tconfig>::free(void* ptr, size_t size)
     }
 }
 
-template<typename Tconfig>
-bool dynamic_slab<Tconfig>::free_unsized(void* ptr)
+template<typename Tconfig, page_source Tsource>
+template<size_t Tsize>
+void* dynamic_slab<Tconfig, Tsource>::palloc()
+{
+    if (m_placement == placement::fullest_first)
+        return palloc(Tsize);
+
+    for (slab_node* node = head_of(lifetime::short_lived).load(std::memory_order_acquire); node; node = node->next)
+    {
+        void* p = node->value.template alloc<Tsize>();
+        if (p)
+            return p;
+    }
+    return palloc(Tsize);
+}
+
+template<typename Tconfig, page_source Tsource>
+template<size_t Tsize>
+void dynamic_slab<Tconfig, Tsource>::free(void* ptr)
 {
     if (ptr == nullptr)
-        return false;
+        return;
 
     size_t owner = m_tree.lookup(ptr);
-    if (owner != 0)
+    if (owner != 0) [[likely]]
     {
-        return reinterpret_cast<slab_node*>(owner)->value.free_unsized(ptr);
+        reinterpret_cast<slab_node*>(owner)->value.template free<Tsize>(ptr);
     }
+}
 
-    return false;
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::alloc_bulk(size_t size, size_t n, void* out[])
+{
+    // no slab can serve a size without a class, don't grow for it
+    const size_t index = node_slab::size_to_index(size);
+    if (index == static_cast<size_t>(-1) || out == nullptr)
+        return 0;
+
+    palloc_atomic<slab_node*>& head = head_of(lifetime::short_lived);
+
+    size_t done = 0;
+    if (m_placement == placement::fullest_first)
+    {
+        done = alloc_bulk_fullest(index, size, n, out);
+    }
+    else
+    {
+        for (slab_node* node = head.load(std::memory_order_acquire); node && done < n; node = node->next)
+            done += node->value.alloc_bulk(size, n - done, out + done);
+    }
+
+    while (done < n)
+    {
+        // grow under lock and fill from the new head. another thread may have grown while we waited
+        std::lock_guard<pool_mutex> lock(grow_mutex);
+        slab_node* current_head = head.load(std::memory_order_relaxed);
+        if (current_head)
+        {
+            done += current_head->value.alloc_bulk(size, n - done, out + done);
+            if (done == n)
+                break;
+        }
+
+        slab_node* new_node = create_node(head.load(std::memory_order_relaxed));
+        if (!new_node)
+            break;
+
+        head.store(new_node, std::memory_order_release);
+        node_count.fetch_add(1, std::memory_order_relaxed);
+
+        size_t got = new_node->value.alloc_bulk(size, n - done, out + done);
+        if (got == 0)
+            break; // size class has no blocks in a fresh slab either
+        done += got;
+    }
+    return done;
 }
 
-template<typename Tconfig>
-size_t dynamic_slab<Tconfig>::shrink()
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::free_bulk(size_t size, void* const ptrs[], size_t n)
 {
-    std::lock_guard<pool_mutex> lock(grow_mutex);
+    if (ptrs == nullptr || size == 0 || size == static_cast<size_t>(-1))
+        return;
 
-    slab_node* current_head = head.load(std::memory_order_relaxed);
-    if (!current_head)
-        return 0;
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t owner = m_tree.lookup(ptrs[i]);
+        if (owner == 0)
+        {
+            ++i;
+            continue;
+        }
 
-    size_t reclaimed = 0;
-    slab_node* prev = current_head;
-    slab_node* node = current_head->next;
+        // bulk frees usually come back in allocation order, so neighbours share a slab
+        node_slab& value = reinterpret_cast<slab_node*>(owner)->value;
+        size_t end = i + 1;
+        while (end < n && static_cast<std::byte*>(ptrs[end]) >= value.region_start() && static_cast<std::byte*>(ptrs[end]) < value.region_end())
+            ++end;
+
+        value.free_bulk(size, ptrs + i, end - i);
+        i = end;
+    }
+}
+
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::free_deferred(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
 
-    // walk the list starting from second node (head is always kept)
-    while (node)
+    size_t owner = m_tree.lookup(ptr);
+    if (owner != 0) [[likely]]
     {
-        slab_node* next = node->next;
+        reinterpret_cast<slab_node*>(owner)->value.free_deferred(ptr, size);
+    }
+}
 
-        if (node->value.get_total_free() == node->value.get_total_capacity())
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::drain()
+{
+    // the slabs share this thread's deferred buffer, draining through any one of them releases it all
+    for (palloc_atomic<slab_node*>& head : heads)
+    {
+        if (slab_node* node = head.load(std::memory_order_acquire))
         {
-            // slab is completely empty — unlink and reclaim
-            prev->next = next;
+            node->value.drain();
+            return;
+        }
+    }
+}
 
-            // remove radix tree entry for this node's contiguous region
-            m_tree.remove(static_cast<void*>(node->value.region_start()), static_cast<void*>(node->value.region_end()));
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::prewarm(const std::array<size_t, Tconfig::NUM_SIZE_CLASSES>& per_class_counts)
+{
+    auto free_blocks = [](const node_slab& value, size_t index) {
+        return value.get_pool_free_space(index) / value.get_pool_block_size(index);
+    };
+    palloc_atomic<slab_node*>& head = head_of(lifetime::short_lived);
 
-            node->~slab_node();
-            AL::platform_mem::free(node, sizeof(slab_node));
-            node_count.fetch_sub(1, std::memory_order_relaxed);
-            ++reclaimed;
+    {
+        std::lock_guard<pool_mutex> lock(grow_mutex);
+        while (true)
+        {
+            std::array<size_t, Tconfig::NUM_SIZE_CLASSES> available{};
+            for (slab_node* node = head.load(std::memory_order_relaxed); node; node = node->next)
+            {
+                for (size_t i = 0; i < Tconfig::NUM_SIZE_CLASSES; ++i)
+                    available[i] += free_blocks(node->value, i);
+            }
+
+            bool short_of_blocks = false;
+            for (size_t i = 0; i < Tconfig::NUM_SIZE_CLASSES; ++i)
+                short_of_blocks |= available[i] < per_class_counts[i];
+            if (!short_of_blocks)
+                break;
+
+            slab_node* new_node = create_node(head.load(std::memory_order_relaxed));
+            if (!new_node)
+                break;
+            head.store(new_node, std::memory_order_release);
+            node_count.fetch_add(1, std::memory_order_relaxed);
         }
-        else
+    }
+
+    std::array<size_t, Tconfig::NUM_SIZE_CLASSES> remaining = per_class_counts;
+    size_t covered = 0;
+    for (slab_node* node = head.load(std::memory_order_acquire); node; node = node->next)
+    {
+        std::array<size_t, Tconfig::NUM_SIZE_CLASSES> share{};
+        bool any = false;
+        for (size_t i = 0; i < Tconfig::NUM_SIZE_CLASSES; ++i)
         {
-            prev = node;
+            const size_t available = free_blocks(node->value, i);
+            share[i] = remaining[i] < available ? remaining[i] : available;
+            remaining[i] -= share[i];
+            any |= share[i] != 0;
         }
+        if (any)
+            covered += node->value.prewarm(share);
+    }
+    return covered;
+}
+
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::release_warm()
+{
+    for_each_node([](slab_node* node) { node->value.release_warm(); });
+}
+
+template<typename Tconfig, page_source Tsource>
+bool dynamic_slab<Tconfig, Tsource>::free_unsized(void* ptr)
+{
+    if (ptr == nullptr)
+        return false;
 
-        node = next;
+    size_t owner = m_tree.lookup(ptr);
+    if (owner != 0)
+    {
+        return reinterpret_cast<slab_node*>(owner)->value.free_unsized(ptr);
     }
 
+    return false;
+}
+
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::shrink()
+{
+    std::lock_guard<pool_mutex> lock(grow_mutex);
+
+    size_t reclaimed = 0;
+    for (palloc_atomic<slab_node*>& head : heads)
+    {
+        slab_node* current_head = head.load(std::memory_order_relaxed);
+        if (!current_head)
+            continue;
+
+        slab_node* prev = current_head;
+        slab_node* node = current_head->next;
+
+        // walk the list starting from second node (head is always kept)
+        while (node)
+        {
+            slab_node* next = node->next;
+
+            if (node->value.get_total_free() == node->value.get_total_capacity())
+            {
+                // slab is completely empty — unlink and reclaim
+                prev->next = next;
+
+                // remove radix tree entry for this node's contiguous region
+                m_tree.remove(static_cast<void*>(node->value.region_start()), static_cast<void*>(node->value.region_end()));
+
+                destroy_node(node);
+                node_count.fetch_sub(1, std::memory_order_relaxed);
+                ++reclaimed;
+            }
+            else
+            {
+                prev = node;
+            }
+
+            node = next;
+        }
+    }
+
+    if (reclaimed != 0)
+        clear_preferred();
     return reclaimed;
 }
 
-template<typename Tconfig>
-void dynamic_slab<Tconfig>::purge()
+template<typename Tconfig, page_source Tsource>
+void dynamic_slab<Tconfig, Tsource>::purge()
 {
     std::lock_guard<pool_mutex> lock(grow_mutex);
 
-    slab_node* current = head.load(std::memory_order_relaxed);
-    while (current)
+    for (palloc_atomic<slab_node*>& head : heads)
     {
-        slab_node* next = current->next;
-        current->~slab_node();
-        AL::platform_mem::free(current, sizeof(slab_node));
-        current = next;
+        slab_node* current = head.load(std::memory_order_relaxed);
+        while (current)
+        {
+            slab_node* next = current->next;
+            destroy_node(current);
+            current = next;
+        }
+        head.store(nullptr, std::memory_order_release);
     }
 
-    head.store(nullptr, std::memory_order_release);
     node_count.store(0, std::memory_order_relaxed);
+    clear_preferred();
     m_tree.clear();
 }
 
-template<typename Tconfig>
-size_t dynamic_slab<Tconfig>::get_total_capacity() const
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::get_total_capacity() const
 {
     size_t total = 0;
-    for (slab_node* node = head.load(std::memory_order_acquire); node; node = node->next)
-        total += node->value.get_total_capacity();
+    for_each_node([&total](const slab_node* node) { total += node->value.get_total_capacity(); });
     return total;
 }
 
-template<typename Tconfig>
-size_t dynamic_slab<Tconfig>::get_total_free() const
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::get_total_free() const
 {
     size_t total = 0;
-    for (slab_node* node = head.load(std::memory_order_acquire); node; node = node->next)
-        total += node->value.get_total_free();
+    for_each_node([&total](const slab_node* node) { total += node->value.get_total_free(); });
     return total;
 }
 
-template<typename Tconfig>
-size_t dynamic_slab<Tconfig>::get_slab_count() const
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::get_slab_count() const
 {
     return node_count.load(std::memory_order_relaxed);
 }
 
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::get_slab_count(lifetime hint) const
+{
+    size_t count = 0;
+    for (slab_node* node = heads[static_cast<size_t>(hint)].load(std::memory_order_acquire); node; node = node->next)
+        ++count;
+    return count;
+}
+
+template<typename Tconfig, page_source Tsource>
+size_t dynamic_slab<Tconfig, Tsource>::get_huge_page_bytes() const
+{
+    size_t total = 0;
+    for_each_node([&total](const slab_node* node) { total += node->value.get_huge_page_bytes(); });
+    return total;
+}
+
 using default_dynamic_slab = dynamic_slab<slab_config<>>;
 
 } // namespace AL
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "page_source.h"
+#include "platform.h"
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace AL
+{
+
+// ─── region_source ───────────────────────────────────────────────────────────
+
+PALLOC_INLINE region_source::region_source(void* base, std::size_t size) noexcept
+{
+    const uintptr_t page_mask = platform_mem::page_size() - 1;
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(base) + page_mask) & ~page_mask;
+    const uintptr_t end = reinterpret_cast<uintptr_t>(base) + size;
+    if (begin >= end)
+        return;
+
+    m_begin = reinterpret_cast<std::byte*>(begin);
+    m_cursor = m_begin;
+    m_end = reinterpret_cast<std::byte*>(end);
+}
+
+PALLOC_INLINE region_source::region_source(region_source&& other) noexcept
+    : m_begin(std::exchange(other.m_begin, nullptr)), m_cursor(std::exchange(other.m_cursor, nullptr)), m_end(std::exchange(other.m_end, nullptr))
+{}
+
+PALLOC_INLINE region_source& region_source::operator=(region_source&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    m_begin = std::exchange(other.m_begin, nullptr);
+    m_cursor = std::exchange(other.m_cursor, nullptr);
+    m_end = std::exchange(other.m_end, nullptr);
+    return *this;
+}
+
+PALLOC_INLINE void* region_source::alloc(std::size_t size, mem_flags flags) noexcept
+{
+    const std::size_t page = platform_mem::page_size();
+    size = ((size + page - 1) / page) * page;
+    if (size == 0 || size > static_cast<std::size_t>(m_end - m_cursor))
+        return nullptr;
+
+    std::byte* ptr = m_cursor;
+#ifndef _WIN32
+    if (has_flag(flags, mem_flags::lock) && mlock(ptr, size) != 0)
+        return nullptr;
+#endif
+    if (has_flag(flags, mem_flags::populate | mem_flags::prefault))
+        platform_mem::touch(ptr, size);
+
+    m_cursor += size;
+    return ptr;
+}
+
+PALLOC_INLINE bool region_source::free(void* ptr, std::size_t size) noexcept
+{
+    auto* p = static_cast<std::byte*>(ptr);
+    if (p < m_begin || p >= m_cursor)
+        return false;
+
+    const std::size_t page = platform_mem::page_size();
+    size = ((size + page - 1) / page) * page;
+    if (p + size == m_cursor)
+        m_cursor = p;
+    return true;
+}
+
+PALLOC_INLINE std::size_t region_source::page_size() const noexcept
+{
+    return platform_mem::page_size();
+}
+
+PALLOC_INLINE std::size_t region_source::get_used() const noexcept
+{
+    return static_cast<std::size_t>(m_cursor - m_begin);
+}
+
+PALLOC_INLINE std::size_t region_source::get_capacity() const noexcept
+{
+    return static_cast<std::size_t>(m_end - m_begin);
+}
+
+// ─── memfd_source ────────────────────────────────────────────────────────────
+
+PALLOC_INLINE memfd_source::memfd_source(memfd_source&& other) noexcept
+    : m_fd(std::exchange(other.m_fd, -1)), m_used(std::exchange(other.m_used, 0)), m_capacity(std::exchange(other.m_capacity, 0))
+{}
+
+PALLOC_INLINE memfd_source& memfd_source::operator=(memfd_source&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+#if defined(__linux__)
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+    m_fd = std::exchange(other.m_fd, -1);
+    m_used = std::exchange(other.m_used, 0);
+    m_capacity = std::exchange(other.m_capacity, 0);
+    return *this;
+}
+
+PALLOC_INLINE std::size_t memfd_source::page_size() const noexcept
+{
+    return platform_mem::page_size();
+}
+
+PALLOC_INLINE std::size_t memfd_source::get_used() const noexcept
+{
+    return m_used;
+}
+
+PALLOC_INLINE std::size_t memfd_source::get_capacity() const noexcept
+{
+    return m_capacity;
+}
+
+PALLOC_INLINE int memfd_source::fd() const noexcept
+{
+    return m_fd;
+}
+
+#if defined(__linux__)
+
+PALLOC_INLINE memfd_source::memfd_source(std::size_t capacity, const char* name)
+{
+    const std::size_t page = platform_mem::page_size();
+    capacity = ((capacity + page - 1) / page) * page;
+
+    m_fd = memfd_create(name, MFD_CLOEXEC);
+    if (m_fd < 0)
+        throw std::bad_alloc();
+    if (ftruncate(m_fd, static_cast<off_t>(capacity)) != 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+        throw std::bad_alloc();
+    }
+    m_capacity = capacity;
+}
+
+PALLOC_INLINE memfd_source::~memfd_source()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+PALLOC_INLINE void* memfd_source::alloc(std::size_t size, mem_flags flags) noexcept
+{
+    const std::size_t page = platform_mem::page_size();
+    size = ((size + page - 1) / page) * page;
+    if (m_fd < 0 || size == 0 || size > m_capacity - m_used)
+        return nullptr;
+    if (no_syscall_scope::active())
+    {
+        no_syscall_scope::refuse();
+        return nullptr;
+    }
+
+    int map_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (has_flag(flags, mem_flags::populate))
+        map_flags |= MAP_POPULATE;
+#endif
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, map_flags, m_fd, static_cast<off_t>(m_used));
+    if (ptr == MAP_FAILED)
+        return nullptr;
+
+    if (has_flag(flags, mem_flags::lock) && mlock(ptr, size) != 0)
+    {
+        munmap(ptr, size);
+        return nullptr;
+    }
+    if (has_flag(flags, mem_flags::prefault))
+        platform_mem::touch(ptr, size);
+
+    m_used += size;
+    return ptr;
+}
+
+PALLOC_INLINE bool memfd_source::free(void* ptr, std::size_t size) noexcept
+{
+    // a plain munmap, deferred inside a no_syscall_scope
+    return platform_mem::free(ptr, size);
+}
+
+#else
+
+PALLOC_INLINE memfd_source::memfd_source(std::size_t, const char*)
+{
+    throw std::bad_alloc();
+}
+
+PALLOC_INLINE memfd_source::~memfd_source() = default;
+
+PALLOC_INLINE void* memfd_source::alloc(std::size_t, mem_flags) noexcept
+{
+    return nullptr;
+}
+
+PALLOC_INLINE bool memfd_source::free(void*, std::size_t) noexcept
+{
+    return false;
+}
+
+#endif
+
+} // namespace AL
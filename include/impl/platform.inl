@@ -0,0 +1,148 @@
+#pragma once
+
+#include "platform.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace AL
+{
+
+// a spin lock: a refused release must not block in the kernel either
+struct platform_mem::release_queue
+{
+    struct entry
+    {
+        void* ptr;
+        std::size_t size;
+    };
+
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    std::size_t count = 0;
+    std::size_t leaked = 0; // bytes
+    entry entries[deferred_capacity];
+
+    void lock() noexcept
+    {
+        while (busy.test_and_set(std::memory_order_acquire))
+        {}
+    }
+    void unlock() noexcept
+    {
+        busy.clear(std::memory_order_release);
+    }
+};
+
+PALLOC_INLINE platform_mem::release_queue& platform_mem::deferred_releases() noexcept
+{
+    static release_queue queue;
+    return queue;
+}
+
+PALLOC_INLINE bool platform_mem::defer_release(void* ptr, std::size_t size) noexcept
+{
+    no_syscall_scope::refuse();
+
+    // never unmapped when the queue is full: the scope promises no kernel calls
+    release_queue& queue = deferred_releases();
+    queue.lock();
+    if (queue.count < deferred_capacity)
+        queue.entries[queue.count++] = {ptr, size};
+    else
+        queue.leaked += size;
+    queue.unlock();
+    return true;
+}
+
+PALLOC_INLINE std::size_t platform_mem::release_deferred() noexcept
+{
+    // it would only queue them again
+    if (no_syscall_scope::active())
+        return 0;
+
+    release_queue& queue = deferred_releases();
+    std::size_t released = 0;
+    while (true)
+    {
+        queue.lock();
+        if (queue.count == 0)
+        {
+            queue.unlock();
+            return released;
+        }
+        release_queue::entry next = queue.entries[--queue.count];
+        queue.unlock();
+
+        unmap(next.ptr, next.size);
+        ++released;
+    }
+}
+
+PALLOC_INLINE std::size_t platform_mem::deferred_count() noexcept
+{
+    release_queue& queue = deferred_releases();
+    queue.lock();
+    std::size_t count = queue.count;
+    queue.unlock();
+    return count;
+}
+
+PALLOC_INLINE std::size_t platform_mem::leaked_bytes() noexcept
+{
+    release_queue& queue = deferred_releases();
+    queue.lock();
+    std::size_t leaked = queue.leaked;
+    queue.unlock();
+    return leaked;
+}
+
+PALLOC_INLINE std::size_t platform_mem::huge_page_bytes(const void* ptr, std::size_t size) noexcept
+{
+#ifdef __linux__
+    std::FILE* smaps = std::fopen("/proc/self/smaps", "r");
+    if (smaps == nullptr)
+        return 0;
+
+    const auto lo = reinterpret_cast<std::uintptr_t>(ptr);
+    const std::uintptr_t hi = lo + size;
+    std::size_t overlap = 0; // bytes of the current mapping that fall inside [lo, hi)
+    std::size_t total = 0;
+
+    char line[512];
+    while (std::fgets(line, sizeof(line), smaps) != nullptr)
+    {
+        unsigned long start = 0;
+        unsigned long end = 0;
+        if (std::sscanf(line, "%lx-%lx ", &start, &end) == 2)
+        {
+            // mapping header: "start-end perms offset dev inode path"
+            std::uintptr_t from = start > lo ? start : lo;
+            std::uintptr_t to = end < hi ? end : hi;
+            overlap = from < to ? to - from : 0;
+            continue;
+        }
+
+        if (overlap == 0)
+            continue;
+
+        // per-mapping counters are totals for the whole mapping, clamp them to the part we asked about
+        unsigned long kb = 0;
+        if (std::sscanf(line, "AnonHugePages: %lu kB", &kb) == 1 || std::sscanf(line, "Private_Hugetlb: %lu kB", &kb) == 1 ||
+            std::sscanf(line, "Shared_Hugetlb: %lu kB", &kb) == 1)
+        {
+            std::size_t bytes = static_cast<std::size_t>(kb) * 1024;
+            total += bytes < overlap ? bytes : overlap;
+        }
+    }
+
+    std::fclose(smaps);
+    return total;
+#else
+    (void)ptr;
+    (void)size;
+    return 0;
+#endif
+}
+
+} // namespace AL
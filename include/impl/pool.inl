@@ -0,0 +1,279 @@
+#pragma once
+
+#include "pool.h"
+#include "platform.h"
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <span>
+
+namespace AL
+{
+PALLOC_INLINE pool::pool()
+{
+    clear();
+}
+
+PALLOC_INLINE pool::pool(size_t block_size, size_t block_count, mem_flags flags) : pool()
+{
+    init(block_size, block_count, flags);
+}
+
+PALLOC_INLINE pool::pool(pool&& other) noexcept
+    : m_region(other.m_region), m_region_size(other.m_region_size), m_release(other.m_release), m_release_ctx(other.m_release_ctx), m_view(other.m_view),
+      m_free_count(other.m_free_count.load())
+{
+    other.clear();
+}
+
+PALLOC_INLINE pool& pool::operator=(pool&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    if (m_region != nullptr)
+        m_release(m_release_ctx, m_region, m_region_size);
+
+    m_region = other.m_region;
+    m_region_size = other.m_region_size;
+    m_release = other.m_release;
+    m_release_ctx = other.m_release_ctx;
+    m_view = other.m_view;
+    m_free_count.store(other.m_free_count.load());
+
+    other.clear();
+    return *this;
+}
+
+PALLOC_INLINE void pool::init(size_t block_size, size_t block_count, mem_flags flags)
+{
+    init(platform_mem{}, block_size, block_count, flags);
+}
+
+PALLOC_INLINE size_t pool::normalize_block_size(size_t block_size)
+{
+    if (block_size < sizeof(void*))
+    {
+#if PALLOC_DEBUG
+        std::cerr << "WARNING: Pool block size " << block_size << " is too small. "
+                  << "Rounded up to " << sizeof(void*) << " bytes.\n";
+#endif
+        block_size = sizeof(void*);
+    }
+
+    return std::bit_ceil(block_size);
+}
+
+PALLOC_INLINE void pool::adopt_region(void* region, size_t region_size, release_fn release, void* release_ctx, size_t block_size, size_t block_count,
+                        pool_view::commit_fn commit, bool zeroed)
+{
+    assert(m_region == nullptr && "pool likely already initialized correctly.");
+
+    m_region = static_cast<std::byte*>(region);
+    m_region_size = region_size;
+    m_release = release;
+    m_release_ctx = release_ctx;
+    if (commit != nullptr)
+    {
+        if (!m_view.init_from_reserved(m_region, block_size, block_count, commit))
+        {
+            m_release(m_release_ctx, m_region, m_region_size);
+            clear();
+            throw std::bad_alloc();
+        }
+    }
+    else
+    {
+        m_view.init_from_region(m_region, block_size, block_count, zeroed);
+    }
+    m_free_count.store(block_count, std::memory_order_relaxed);
+}
+
+PALLOC_INLINE void pool::init_from_region(void* base, size_t block_size, size_t block_count, bool zeroed)
+{
+    assert(!m_view.is_initialized() && "pool likely already initialized");
+    assert(m_region == nullptr && "pool already owns memory");
+
+    // non-owning: m_region stays nullptr so destructor won't munmap
+    m_view.init_from_region(base, block_size, block_count, zeroed);
+    m_free_count.store(block_count, std::memory_order_relaxed);
+}
+
+PALLOC_INLINE void pool::init_from_reserved(void* base, size_t block_size, size_t block_count, pool_view::commit_fn commit)
+{
+    assert(!m_view.is_initialized() && "pool likely already initialized");
+    assert(m_region == nullptr && "pool already owns memory");
+
+    if (!m_view.init_from_reserved(base, block_size, block_count, commit))
+        throw std::bad_alloc();
+    m_free_count.store(block_count, std::memory_order_relaxed);
+}
+
+PALLOC_INLINE pool::~pool()
+{
+    if (m_region == nullptr)
+        return;
+
+    bool freed = m_release(m_release_ctx, m_region, m_region_size);
+
+#if PALLOC_DEBUG
+    if (!freed)
+        std::cerr << "WARNING: munmap failed in pool destructor\n";
+#endif
+
+    m_region = nullptr;
+}
+
+PALLOC_INLINE void* pool::alloc()
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    check_asserts();
+
+    void* ptr = m_view.alloc();
+    if (ptr != nullptr)
+        m_free_count.store(m_view.free_count(), std::memory_order_relaxed);
+    return ptr;
+}
+
+PALLOC_INLINE size_t pool::alloc_batched_internal(size_t num_objects, void* out[])
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    if (!out)
+        return 0;
+
+    check_asserts();
+
+    // one bitmap scan for the whole range
+    size_t i = m_view.alloc_batch(num_objects, out);
+    m_free_count.store(m_view.free_count(), std::memory_order_relaxed);
+    return i;
+}
+
+PALLOC_INLINE void* pool::calloc()
+{
+    bool is_zero = false;
+    void* ptr = nullptr;
+    {
+        std::lock_guard<pool_mutex> lock(m_mutex);
+        check_asserts();
+
+        ptr = m_view.alloc(is_zero);
+        if (ptr != nullptr)
+            m_free_count.store(m_view.free_count(), std::memory_order_relaxed);
+    }
+
+    // zero outside the lock
+    if (ptr != nullptr && !is_zero)
+        platform_mem::zero(ptr, m_view.block_size());
+    return ptr;
+}
+
+PALLOC_INLINE void* pool::alloc_pristine_internal()
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    check_asserts();
+
+    void* ptr = m_view.alloc_pristine();
+    if (ptr != nullptr)
+        m_free_count.store(m_view.free_count(), std::memory_order_relaxed);
+    return ptr;
+}
+
+PALLOC_INLINE size_t pool::prefault(size_t count)
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    check_asserts();
+    return m_view.prefault(count);
+}
+
+PALLOC_INLINE void pool::reset()
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    check_asserts();
+    m_view.reset();
+    m_free_count.store(m_view.block_count(), std::memory_order_relaxed);
+}
+
+PALLOC_INLINE void pool::clear()
+{
+    m_region = nullptr;
+    m_region_size = 0;
+    m_release = nullptr;
+    m_release_ctx = nullptr;
+    m_view = pool_view{};
+    m_free_count.store(0, std::memory_order_relaxed);
+}
+
+PALLOC_INLINE bool pool::owns(void* ptr) const
+{
+    return m_view.owns(ptr);
+}
+
+PALLOC_INLINE void pool::free(void* ptr)
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    if (ptr == nullptr)
+        return;
+
+    check_asserts();
+    assert(owns(ptr) && "Pointer does not belong to this pool");
+
+    m_view.free(ptr);
+    m_free_count.store(m_view.free_count(), std::memory_order_relaxed);
+}
+
+PALLOC_INLINE void pool::free_batched_internal(size_t num_objects, void* const in[])
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    if (!in)
+        return;
+
+    check_asserts();
+
+    // null entries are skipped, ownership is asserted per pointer
+    m_view.free_batch(std::span<void* const>(in, num_objects));
+    m_free_count.store(m_view.free_count(), std::memory_order_relaxed);
+}
+
+PALLOC_INLINE size_t pool::get_free_space() const
+{
+    return m_free_count.load(std::memory_order_relaxed) * m_view.block_size();
+}
+
+PALLOC_INLINE size_t pool::get_capacity() const
+{
+    return m_view.capacity();
+}
+
+PALLOC_INLINE size_t pool::get_huge_page_bytes() const
+{
+    return AL::platform_mem::huge_page_bytes(m_region, m_region_size);
+}
+
+PALLOC_INLINE size_t pool::get_pristine_count() const
+{
+    std::lock_guard<pool_mutex> lock(m_mutex);
+    return m_view.pristine_count();
+}
+
+PALLOC_INLINE size_t pool::get_block_size() const
+{
+    return m_view.block_size();
+}
+
+PALLOC_INLINE size_t pool::get_block_count() const
+{
+    return m_view.block_count();
+}
+
+PALLOC_INLINE void pool::check_asserts() const
+{
+#if PALLOC_DEBUG
+    assert(m_view.is_initialized() && "pool not initialized correctly.");
+#endif
+}
+
+} // namespace AL
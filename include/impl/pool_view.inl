@@ -0,0 +1,402 @@
+#pragma once
+
+#include "pool_view.h"
+#include "platform.h"
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+namespace AL
+{
+
+PALLOC_INLINE size_t pool_view::required_region_size(size_t block_size, size_t block_count) noexcept
+{
+    size_t bitmap_words = (block_count + 63) / 64;
+    size_t bitmap_bytes = bitmap_words * sizeof(uint64_t);
+    // payload must start at block_size alignment
+    size_t aligned_offset = ((bitmap_bytes + block_size - 1) / block_size) * block_size;
+    return aligned_offset + block_size * block_count;
+}
+
+PALLOC_INLINE void pool_view::init_from_region(void* base, size_t block_size, size_t block_count, bool zeroed) noexcept
+{
+    assert(base != nullptr && "base must not be null");
+    assert(block_size > 0 && std::has_single_bit(block_size) && "block_size must be a power of 2");
+    assert(block_size >= sizeof(void*) && "block_size must be at least sizeof(void*)");
+    assert(block_count > 0 && "block_count must be positive");
+    assert((reinterpret_cast<uintptr_t>(base) % block_size) == 0 && "base must be aligned to at least block_size");
+
+    m_block_size = block_size;
+    m_block_count = block_count;
+    m_free_count = block_count;
+    m_bitmap_words = (block_count + 63) / 64;
+    m_hint = 0;
+    m_block_shift = static_cast<size_t>(std::countr_zero(block_size));
+
+    m_bitmap = static_cast<uint64_t*>(base);
+    std::memset(m_bitmap, 0, m_bitmap_words * sizeof(uint64_t));
+
+    // mark trailing bits beyond m_block_count as allocated so the hint
+    // can advance past the last word when all valid blocks are used
+    size_t tail = m_block_count % 64;
+    if (tail != 0)
+        m_bitmap[m_bitmap_words - 1] = ~uint64_t(0) << tail;
+
+    // align payload to block_size
+    size_t bitmap_bytes = m_bitmap_words * sizeof(uint64_t);
+    void* payload_ptr = static_cast<std::byte*>(base) + bitmap_bytes;
+    size_t remaining = required_region_size(block_size, block_count) - bitmap_bytes;
+
+    void* aligned = std::align(block_size, block_size * block_count, payload_ptr, remaining);
+    assert(aligned != nullptr && "failed to align payload region");
+
+    m_memory = static_cast<std::byte*>(aligned);
+    m_commit_end = memory_end();
+    m_reserve_end = memory_end();
+    m_clean_floor = zeroed ? m_memory : memory_end();
+}
+
+PALLOC_INLINE bool pool_view::init_from_reserved(void* base, size_t block_size, size_t block_count, commit_fn commit) noexcept
+{
+    const uintptr_t page_mask = platform_mem::page_size() - 1;
+    const uintptr_t base_addr = reinterpret_cast<uintptr_t>(base);
+    const uintptr_t first_page = base_addr & ~page_mask;
+    const uintptr_t bitmap_end = (base_addr + ((block_count + 63) / 64) * sizeof(uint64_t) + page_mask) & ~page_mask;
+
+    if (!commit(reinterpret_cast<void*>(first_page), bitmap_end - first_page))
+        return false;
+
+    init_from_region(base, block_size, block_count, true);
+    m_commit = commit;
+    m_reserve_end = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(memory_end()) + page_mask) & ~page_mask);
+    m_commit_end = reinterpret_cast<std::byte*>(bitmap_end);
+    return true;
+}
+
+PALLOC_INLINE bool pool_view::commit_to(std::byte* end) noexcept
+{
+    const uintptr_t page_mask = platform_mem::page_size() - 1;
+
+    // commit at least one chunk so the syscall is amortized over many blocks
+    uintptr_t target = reinterpret_cast<uintptr_t>(end);
+    uintptr_t chunk_end = reinterpret_cast<uintptr_t>(m_commit_end) + COMMIT_CHUNK;
+    if (target < chunk_end)
+        target = chunk_end;
+    target = (target + page_mask) & ~page_mask;
+    if (target > reinterpret_cast<uintptr_t>(m_reserve_end))
+        target = reinterpret_cast<uintptr_t>(m_reserve_end);
+
+    if (!m_commit(m_commit_end, target - reinterpret_cast<uintptr_t>(m_commit_end)))
+        return false;
+
+    m_commit_end = reinterpret_cast<std::byte*>(target);
+    return true;
+}
+
+PALLOC_INLINE void* pool_view::alloc() noexcept
+{
+    if (m_free_count == 0)
+        return nullptr;
+
+    for (size_t w = m_hint; w < m_bitmap_words; ++w)
+    {
+        uint64_t word = m_bitmap[w];
+        if (word == ~uint64_t(0))
+            continue; // all bits set (all allocated)
+
+        size_t bit = static_cast<size_t>(std::countr_zero(static_cast<uint64_t>(~word)));
+        size_t block_idx = w * 64 + bit;
+
+        if (block_idx >= m_block_count)
+            return nullptr;
+
+        std::byte* block = m_memory + (block_idx << m_block_shift);
+        if (block + m_block_size > m_commit_end) [[unlikely]]
+        {
+            if (!commit_to(block + m_block_size))
+                return nullptr;
+        }
+
+        m_bitmap[w] |= (uint64_t(1) << bit);
+        --m_free_count;
+        // first fit: every block above the floor is free, so a block at or past it is the floor itself
+        if (block >= m_clean_floor)
+            m_clean_floor = block + m_block_size;
+
+        // advance hint past full words
+        if (m_bitmap[w] == ~uint64_t(0))
+            m_hint = w + 1;
+
+        return block;
+    }
+
+    return nullptr;
+}
+
+PALLOC_INLINE size_t pool_view::alloc_batch(size_t count, void* out[]) noexcept
+{
+    if (m_free_count == 0 || count == 0)
+        return 0;
+
+    size_t found = 0;
+    bool commit_failed = false;
+
+    for (size_t w = m_hint; w < m_bitmap_words && found < count && !commit_failed; ++w)
+    {
+        uint64_t word = m_bitmap[w];
+        if (word == ~uint64_t(0))
+            continue;
+
+        uint64_t free_bits = ~word;
+        uint64_t new_alloc = 0;
+
+        while (free_bits && found < count)
+        {
+            size_t bit = static_cast<size_t>(std::countr_zero(free_bits));
+            size_t block_idx = w * 64 + bit;
+
+            // trailing bits are pre-set allocated; this is a safety guard
+            if (block_idx >= m_block_count)
+            {
+                free_bits = 0;
+                break;
+            }
+
+            std::byte* block = m_memory + (block_idx << m_block_shift);
+            if (block + m_block_size > m_commit_end) [[unlikely]]
+            {
+                if (!commit_to(block + m_block_size))
+                {
+                    commit_failed = true;
+                    break;
+                }
+            }
+
+            out[found++] = block;
+            uint64_t b = uint64_t(1) << bit;
+            new_alloc |= b;
+            free_bits &= free_bits - 1; // clear lowest set bit
+        }
+
+        if (new_alloc)
+        {
+            m_bitmap[w] |= new_alloc;
+            if (m_bitmap[w] == ~uint64_t(0))
+                m_hint = w + 1;
+        }
+    }
+
+    m_free_count -= found;
+    // blocks are found in ascending order, the last one is the highest
+    if (found != 0 && static_cast<std::byte*>(out[found - 1]) >= m_clean_floor)
+        m_clean_floor = static_cast<std::byte*>(out[found - 1]) + m_block_size;
+    return found;
+}
+
+PALLOC_INLINE size_t pool_view::prefault(size_t count) noexcept
+{
+    const uintptr_t page = platform_mem::page_size();
+    uintptr_t untouched = 0; // pages below this one are done
+    size_t found = 0;
+
+    for (size_t w = m_hint; w < m_bitmap_words && found < count; ++w)
+    {
+        uint64_t free_bits = ~m_bitmap[w];
+        while (free_bits && found < count)
+        {
+            size_t block_idx = w * 64 + static_cast<size_t>(std::countr_zero(free_bits));
+            if (block_idx >= m_block_count)
+                return found;
+
+            std::byte* block = m_memory + (block_idx << m_block_shift);
+            if (block + m_block_size > m_commit_end) [[unlikely]]
+            {
+                if (!commit_to(block + m_block_size))
+                    return found;
+            }
+
+            // the first byte of the block on each page it spans, neighbouring blocks may be in use
+            const uintptr_t first = reinterpret_cast<uintptr_t>(block);
+            const uintptr_t end = first + m_block_size;
+            for (uintptr_t at = first > untouched ? first : untouched; at < end; at = (at & ~(page - 1)) + page)
+            {
+                auto* byte = reinterpret_cast<volatile unsigned char*>(at);
+                *byte = *byte;
+            }
+            // blocks come in ascending order
+            untouched = ((end - 1) & ~(page - 1)) + page;
+
+            ++found;
+            free_bits &= free_bits - 1;
+        }
+    }
+    return found;
+}
+
+PALLOC_INLINE void* pool_view::alloc(bool& is_zero) noexcept
+{
+    std::byte* floor = m_clean_floor;
+    void* block = alloc();
+    is_zero = block != nullptr && static_cast<std::byte*>(block) >= floor;
+    return block;
+}
+
+PALLOC_INLINE void* pool_view::alloc_pristine() noexcept
+{
+    std::byte* block = m_clean_floor;
+    if (block == nullptr || block >= memory_end())
+        return nullptr;
+
+    if (block + m_block_size > m_commit_end) [[unlikely]]
+    {
+        if (!commit_to(block + m_block_size))
+            return nullptr;
+    }
+
+    size_t block_idx = static_cast<size_t>(block - m_memory) >> m_block_shift;
+    m_bitmap[block_idx >> 6] |= uint64_t(1) << (block_idx & 63);
+    --m_free_count;
+    m_clean_floor = block + m_block_size;
+    return block;
+}
+
+PALLOC_INLINE void* pool_view::calloc() noexcept
+{
+    bool is_zero = false;
+    void* ptr = alloc(is_zero);
+    if (ptr != nullptr && !is_zero)
+        platform_mem::zero(ptr, m_block_size);
+    return ptr;
+}
+
+PALLOC_INLINE void pool_view::free(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    assert(owns(ptr) && "pointer does not belong to this pool_view");
+
+    auto byte_ptr = static_cast<std::byte*>(ptr);
+    size_t offset = static_cast<size_t>(byte_ptr - m_memory);
+    size_t block_idx = offset >> m_block_shift;
+
+    size_t word_idx = block_idx >> 6;
+    size_t bit_idx = block_idx & 63;
+
+    uint64_t mask = uint64_t(1) << bit_idx;
+    assert((m_bitmap[word_idx] & mask) != 0 && "double free: block is not currently allocated");
+
+    if (!(m_bitmap[word_idx] & mask))
+        return; // block already free — no-op to prevent state corruption
+
+    m_bitmap[word_idx] &= ~mask;
+    ++m_free_count;
+
+    // pull hint back so alloc can find this word
+    if (word_idx < m_hint)
+        m_hint = word_idx;
+}
+
+PALLOC_INLINE void pool_view::free_batch(std::span<void* const> ptrs) noexcept
+{
+    size_t count = 0;
+    size_t min_hint = m_hint;
+
+    for (void* ptr : ptrs)
+    {
+        if (ptr == nullptr)
+            continue;
+
+        assert(owns(ptr) && "pointer does not belong to this pool_view");
+
+        auto byte_ptr = static_cast<std::byte*>(ptr);
+        size_t offset = static_cast<size_t>(byte_ptr - m_memory);
+        size_t block_idx = offset >> m_block_shift;
+        size_t word_idx = block_idx >> 6;
+        size_t bit_idx = block_idx & 63;
+
+        uint64_t mask = uint64_t(1) << bit_idx;
+        if (!(m_bitmap[word_idx] & mask))
+            continue; // already free
+
+        m_bitmap[word_idx] &= ~mask;
+        ++count;
+
+        if (word_idx < min_hint)
+            min_hint = word_idx;
+    }
+
+    m_free_count += count;
+    if (min_hint < m_hint)
+        m_hint = min_hint;
+}
+
+PALLOC_INLINE void pool_view::reset() noexcept
+{
+    std::memset(m_bitmap, 0, m_bitmap_words * sizeof(uint64_t));
+
+    size_t tail = m_block_count % 64;
+    if (tail != 0)
+        m_bitmap[m_bitmap_words - 1] = ~uint64_t(0) << tail;
+
+    m_free_count = m_block_count;
+    m_hint = 0;
+}
+
+PALLOC_INLINE size_t pool_view::free_count() const noexcept
+{
+    return m_free_count;
+}
+
+PALLOC_INLINE size_t pool_view::block_count() const noexcept
+{
+    return m_block_count;
+}
+
+PALLOC_INLINE size_t pool_view::block_size() const noexcept
+{
+    return m_block_size;
+}
+
+PALLOC_INLINE size_t pool_view::capacity() const noexcept
+{
+    return m_block_size * m_block_count;
+}
+
+PALLOC_INLINE size_t pool_view::pristine_count() const noexcept
+{
+    if (m_clean_floor == nullptr)
+        return 0;
+    return static_cast<size_t>(memory_end() - m_clean_floor) >> m_block_shift;
+}
+
+PALLOC_INLINE bool pool_view::owns(const void* ptr) const noexcept
+{
+    if (ptr == nullptr || m_memory == nullptr)
+        return false;
+
+    auto byte_ptr = static_cast<const std::byte*>(ptr);
+    if (byte_ptr < m_memory || byte_ptr >= m_memory + m_block_size * m_block_count)
+        return false;
+
+    size_t offset = static_cast<size_t>(byte_ptr - m_memory);
+    return (offset & (m_block_size - 1)) == 0;
+}
+
+PALLOC_INLINE bool pool_view::is_initialized() const noexcept
+{
+    return m_memory != nullptr;
+}
+
+PALLOC_INLINE std::byte* pool_view::memory_start() const noexcept
+{
+    return m_memory;
+}
+
+PALLOC_INLINE std::byte* pool_view::memory_end() const noexcept
+{
+    return m_memory ? m_memory + m_block_size * m_block_count : nullptr;
+}
+
+} // namespace AL
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "shared_pool.h"
+#include "platform.h"
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace AL
+{
+
+PALLOC_INLINE shared_pool::shared_pool(shm_segment&& seg) noexcept : m_segment(std::move(seg))
+{}
+
+PALLOC_INLINE shared_pool shared_pool::create(size_t block_size, size_t block_count, const char* name)
+{
+    if (block_count == 0)
+        throw std::bad_alloc();
+    if (block_size < sizeof(void*))
+        block_size = sizeof(void*);
+    block_size = std::bit_ceil(block_size);
+
+    size_t bitmap_words = (block_count + 63) / 64;
+    size_t bitmap_end = BITMAP_OFFSET + bitmap_words * sizeof(uint64_t);
+    size_t payload_offset = ((bitmap_end + block_size - 1) / block_size) * block_size;
+
+    shm_segment seg = shm_segment::create(payload_offset + block_size * block_count, name);
+
+    auto* hdr = std::construct_at(reinterpret_cast<header*>(seg.base()));
+    hdr->magic = MAGIC;
+    hdr->block_size = block_size;
+    hdr->block_shift = static_cast<uint64_t>(std::countr_zero(block_size));
+    hdr->block_count = block_count;
+    hdr->bitmap_words = bitmap_words;
+    hdr->payload_offset = payload_offset;
+    hdr->free_count.store(block_count, std::memory_order_relaxed);
+    hdr->hint.store(0, std::memory_order_relaxed);
+
+    auto* bitmap = reinterpret_cast<std::atomic<uint64_t>*>(seg.base() + BITMAP_OFFSET);
+    for (size_t w = 0; w < bitmap_words; ++w)
+        std::construct_at(&bitmap[w], uint64_t(0));
+
+    // mark trailing bits beyond block_count as allocated
+    size_t tail = block_count % 64;
+    if (tail != 0)
+        bitmap[bitmap_words - 1].store(~uint64_t(0) << tail, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    return shared_pool(std::move(seg));
+}
+
+PALLOC_INLINE shared_pool shared_pool::open(const char* name)
+{
+    return attach(shm_segment::open(name));
+}
+
+PALLOC_INLINE shared_pool shared_pool::from_fd(int fd)
+{
+    return attach(shm_segment::from_fd(fd));
+}
+
+PALLOC_INLINE shared_pool shared_pool::restore(const char* path)
+{
+    return attach(shm_segment::restore(path));
+}
+
+PALLOC_INLINE bool shared_pool::snapshot(const char* path) const
+{
+    header* hdr = get_header();
+    std::atomic<uint64_t>* bitmap = get_bitmap();
+
+    // everything past the last allocated block stays a hole in the file
+    size_t end = hdr->payload_offset;
+    for (size_t w = hdr->bitmap_words; w-- > 0;)
+    {
+        uint64_t word = bitmap[w].load(std::memory_order_acquire);
+        size_t tail = hdr->block_count % 64;
+        if (w == hdr->bitmap_words - 1 && tail != 0)
+            word &= ~(~uint64_t(0) << tail);
+        if (word != 0)
+        {
+            size_t last = w * 64 + 63 - static_cast<size_t>(std::countl_zero(word));
+            end = hdr->payload_offset + ((last + 1) << hdr->block_shift);
+            break;
+        }
+    }
+    return m_segment.save(path, end);
+}
+
+PALLOC_INLINE shared_pool shared_pool::attach(shm_segment&& seg)
+{
+    if (seg.size() < BITMAP_OFFSET)
+        throw std::bad_alloc();
+
+    auto* hdr = reinterpret_cast<header*>(seg.base());
+    if (hdr->magic != MAGIC || !std::has_single_bit(hdr->block_size) || hdr->bitmap_words != (hdr->block_count + 63) / 64)
+        throw std::bad_alloc();
+    if (hdr->payload_offset < BITMAP_OFFSET + hdr->bitmap_words * sizeof(uint64_t) ||
+        hdr->payload_offset + hdr->block_size * hdr->block_count > seg.size())
+        throw std::bad_alloc();
+
+    return shared_pool(std::move(seg));
+}
+
+PALLOC_INLINE shared_pool::header* shared_pool::get_header() const
+{
+    return reinterpret_cast<header*>(m_segment.base());
+}
+
+PALLOC_INLINE std::atomic<uint64_t>* shared_pool::get_bitmap() const
+{
+    return reinterpret_cast<std::atomic<uint64_t>*>(m_segment.base() + BITMAP_OFFSET);
+}
+
+PALLOC_INLINE std::byte* shared_pool::get_payload() const
+{
+    return m_segment.base() + get_header()->payload_offset;
+}
+
+PALLOC_INLINE void* shared_pool::alloc()
+{
+    header* hdr = get_header();
+    if (hdr->free_count.load(std::memory_order_relaxed) == 0)
+        return nullptr;
+
+    std::atomic<uint64_t>* bitmap = get_bitmap();
+    const size_t words = hdr->bitmap_words;
+    size_t start = hdr->hint.load(std::memory_order_relaxed);
+    if (start >= words)
+        start = 0;
+
+    // wrap around: the hint is only advisory when several processes race on it
+    for (size_t n = 0; n < words; ++n)
+    {
+        size_t w = start + n < words ? start + n : start + n - words;
+        uint64_t word = bitmap[w].load(std::memory_order_relaxed);
+
+        while (word != ~uint64_t(0))
+        {
+            size_t bit = static_cast<size_t>(std::countr_zero(static_cast<uint64_t>(~word)));
+            uint64_t desired = word | (uint64_t(1) << bit);
+
+            // acquire pairs with the release in free so the previous owner's writes are visible
+            if (bitmap[w].compare_exchange_weak(word, desired, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                hdr->free_count.fetch_sub(1, std::memory_order_relaxed);
+                if (desired == ~uint64_t(0))
+                    hdr->hint.store(w + 1, std::memory_order_relaxed);
+                return get_payload() + ((w * 64 + bit) << hdr->block_shift);
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+PALLOC_INLINE void* shared_pool::calloc()
+{
+    void* ptr = alloc();
+    if (ptr != nullptr)
+        std::memset(ptr, 0, get_header()->block_size);
+    return ptr;
+}
+
+PALLOC_INLINE void shared_pool::free(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    assert(owns(ptr) && "Pointer does not belong to this shared_pool");
+
+    header* hdr = get_header();
+    size_t block_idx = static_cast<size_t>(static_cast<std::byte*>(ptr) - get_payload()) >> hdr->block_shift;
+    size_t word_idx = block_idx >> 6;
+    uint64_t mask = uint64_t(1) << (block_idx & 63);
+
+    uint64_t prev = get_bitmap()[word_idx].fetch_and(~mask, std::memory_order_release);
+    assert((prev & mask) != 0 && "double free: block is not currently allocated");
+    if (!(prev & mask))
+        return;
+
+    hdr->free_count.fetch_add(1, std::memory_order_relaxed);
+    if (word_idx < hdr->hint.load(std::memory_order_relaxed))
+        hdr->hint.store(word_idx, std::memory_order_relaxed);
+}
+
+PALLOC_INLINE uint64_t shared_pool::to_offset(const void* ptr) const
+{
+    return static_cast<uint64_t>(static_cast<const std::byte*>(ptr) - m_segment.base());
+}
+
+PALLOC_INLINE void* shared_pool::from_offset(uint64_t offset) const
+{
+    return m_segment.base() + offset;
+}
+
+PALLOC_INLINE bool shared_pool::owns(const void* ptr) const
+{
+    if (ptr == nullptr || m_segment.base() == nullptr)
+        return false;
+
+    header* hdr = get_header();
+    auto byte_ptr = static_cast<const std::byte*>(ptr);
+    std::byte* payload = get_payload();
+    if (byte_ptr < payload || byte_ptr >= payload + hdr->block_size * hdr->block_count)
+        return false;
+
+    return (static_cast<size_t>(byte_ptr - payload) & (hdr->block_size - 1)) == 0;
+}
+
+PALLOC_INLINE size_t shared_pool::get_free_space() const
+{
+    header* hdr = get_header();
+    return hdr->free_count.load(std::memory_order_relaxed) * hdr->block_size;
+}
+
+PALLOC_INLINE size_t shared_pool::get_capacity() const
+{
+    header* hdr = get_header();
+    return hdr->block_size * hdr->block_count;
+}
+
+PALLOC_INLINE size_t shared_pool::get_block_size() const
+{
+    return get_header()->block_size;
+}
+
+PALLOC_INLINE size_t shared_pool::get_block_count() const
+{
+    return get_header()->block_count;
+}
+
+} // namespace AL
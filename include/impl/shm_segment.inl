@@ -0,0 +1,245 @@
+#pragma once
+
+#include "shm_segment.h"
+#include "platform.h"
+#include <cstdio>
+#include <new>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace AL
+{
+
+PALLOC_INLINE shm_segment::~shm_segment()
+{
+    release();
+}
+
+PALLOC_INLINE shm_segment::shm_segment(shm_segment&& other) noexcept : m_base(other.m_base), m_size(other.m_size), m_fd(other.m_fd)
+{
+    other.m_base = nullptr;
+    other.m_size = 0;
+    other.m_fd = -1;
+}
+
+PALLOC_INLINE shm_segment& shm_segment::operator=(shm_segment&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    release();
+    m_base = other.m_base;
+    m_size = other.m_size;
+    m_fd = other.m_fd;
+    other.m_base = nullptr;
+    other.m_size = 0;
+    other.m_fd = -1;
+    return *this;
+}
+
+PALLOC_INLINE void shm_segment::release() noexcept
+{
+#ifndef _WIN32
+    if (m_base != nullptr)
+        munmap(m_base, m_size);
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+    m_base = nullptr;
+    m_size = 0;
+    m_fd = -1;
+}
+
+#ifdef _WIN32
+
+PALLOC_INLINE shm_segment shm_segment::create(size_t, const char*)
+{
+    throw std::bad_alloc();
+}
+
+PALLOC_INLINE shm_segment shm_segment::open(const char*)
+{
+    throw std::bad_alloc();
+}
+
+PALLOC_INLINE shm_segment shm_segment::from_fd(int)
+{
+    throw std::bad_alloc();
+}
+
+PALLOC_INLINE bool shm_segment::unlink(const char*) noexcept
+{
+    return false;
+}
+
+PALLOC_INLINE bool shm_segment::save(const char*, size_t) const noexcept
+{
+    return false;
+}
+
+PALLOC_INLINE shm_segment shm_segment::restore(const char*)
+{
+    throw std::bad_alloc();
+}
+
+PALLOC_INLINE shm_segment shm_segment::map_fd(int)
+{
+    throw std::bad_alloc();
+}
+
+#else
+
+PALLOC_INLINE shm_segment shm_segment::map_fd(int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        throw std::bad_alloc();
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        close(fd);
+        throw std::bad_alloc();
+    }
+
+    shm_segment seg;
+    seg.m_base = static_cast<std::byte*>(ptr);
+    seg.m_size = size;
+    seg.m_fd = fd;
+    return seg;
+}
+
+PALLOC_INLINE shm_segment shm_segment::create(size_t size, const char* name)
+{
+    size_t page_size = platform_mem::page_size();
+    size = ((size + page_size - 1) / page_size) * page_size;
+    if (size == 0)
+        throw std::bad_alloc();
+
+    int fd = -1;
+    if (name == nullptr)
+    {
+#ifdef __linux__
+        fd = memfd_create("palloc", MFD_CLOEXEC);
+#else
+        // no memfd: create a uniquely named object and unlink it right away
+        char tmp[64];
+        std::snprintf(tmp, sizeof(tmp), "/palloc-%ld-%p", static_cast<long>(getpid()), static_cast<void*>(&tmp));
+        fd = shm_open(tmp, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0)
+            shm_unlink(tmp);
+#endif
+    }
+    else
+    {
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+
+    if (fd < 0)
+        throw std::bad_alloc();
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        if (name != nullptr)
+            shm_unlink(name);
+        throw std::bad_alloc();
+    }
+
+    try
+    {
+        return map_fd(fd);
+    }
+    catch (...)
+    {
+        // map_fd closed fd. a named object nobody can map would block every later create with this name
+        if (name != nullptr)
+            shm_unlink(name);
+        throw;
+    }
+}
+
+PALLOC_INLINE shm_segment shm_segment::open(const char* name)
+{
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0)
+        throw std::bad_alloc();
+    return map_fd(fd);
+}
+
+PALLOC_INLINE shm_segment shm_segment::from_fd(int fd)
+{
+    int own = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own < 0)
+        throw std::bad_alloc();
+    return map_fd(own);
+}
+
+PALLOC_INLINE bool shm_segment::unlink(const char* name) noexcept
+{
+    return shm_unlink(name) == 0;
+}
+
+PALLOC_INLINE bool shm_segment::save(const char* path, size_t bytes) const noexcept
+{
+    if (m_base == nullptr || bytes > m_size)
+        return false;
+
+    int fd = ::open(path, O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < bytes)
+    {
+        ssize_t n = ::write(fd, m_base + written, bytes - written);
+        if (n > 0)
+            written += static_cast<size_t>(n);
+        else if (n < 0 && errno == EINTR)
+            continue;
+        else
+            ok = false;
+    }
+
+    ok = ok && ftruncate(fd, static_cast<off_t>(m_size)) == 0;
+    return close(fd) == 0 && ok;
+}
+
+PALLOC_INLINE shm_segment shm_segment::restore(const char* path)
+{
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::bad_alloc();
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        throw std::bad_alloc();
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive
+    close(fd);
+    if (ptr == MAP_FAILED)
+        throw std::bad_alloc();
+
+    shm_segment seg;
+    seg.m_base = static_cast<std::byte*>(ptr);
+    seg.m_size = size;
+    return seg;
+}
+
+#endif
+
+} // namespace AL
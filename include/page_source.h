@@ -0,0 +1,288 @@
+#pragma once
+
+#include "platform.h"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace AL
+{
+
+// a page source hands page-granular regions to an allocator. every allocator takes one as a template
+// parameter (platform_mem by default), so where an instance's memory comes from is a per-instance choice.
+//
+// required:
+//   void*  alloc(size, flags)   nullptr on failure. size is already rounded, see source_round_size()
+//   bool   free(ptr, size)      size is the value that was passed to alloc()
+//   size_t page_size()
+// optional:
+//   size_t round_size(size, flags)      granularity alloc() expects, whole pages otherwise
+//   static bool commit(ptr, size)       with decommit(), marks a source whose alloc() returns reserved pages
+//   static bool decommit(ptr, size)     for mem_flags::lazy_commit. allocators strip lazy_commit for other sources
+//   static constexpr bool zeroed_pages  true if every region from alloc() reads as zero, calloc then skips never-used blocks
+//   using base_source = S               a stateless source this one only adds flags to. allocators map small bookkeeping
+//                                       (a dynamic_slab node header) from S, so the flags reach only the regions
+//
+// allocators hold the source by value. stateful sources are move-only and owned by the allocator they are given to.
+template<typename T>
+concept page_source = requires(T& source, void* ptr, std::size_t size, mem_flags flags) {
+    { source.alloc(size, flags) } -> std::same_as<void*>;
+    { source.free(ptr, size) } -> std::same_as<bool>;
+    { source.page_size() } -> std::convertible_to<std::size_t>;
+};
+
+template<typename T>
+concept committable_page_source = page_source<T> && requires(void* ptr, std::size_t size) {
+    { T::commit(ptr, size) } -> std::same_as<bool>;
+    { T::decommit(ptr, size) } -> std::same_as<bool>;
+};
+
+template<typename T>
+concept zeroing_page_source = page_source<T> && requires {
+    requires T::zeroed_pages;
+};
+
+static_assert(committable_page_source<platform_mem>);
+static_assert(zeroing_page_source<platform_mem>);
+
+// the flags a source is actually asked for
+template<page_source T>
+constexpr mem_flags source_flags(mem_flags flags) noexcept
+{
+    if constexpr (committable_page_source<T>)
+        return flags;
+    else
+        return flags & ~mem_flags::lazy_commit;
+}
+
+template<page_source T>
+std::size_t source_round_size(T& source, std::size_t size, mem_flags flags) noexcept
+{
+    if constexpr (requires { source.round_size(size, flags); })
+    {
+        return source.round_size(size, flags);
+    }
+    else
+    {
+        std::size_t unit = source.page_size();
+        return ((size + unit - 1) / unit) * unit;
+    }
+}
+
+// commit hook handed to pool_view for lazily committed regions
+template<committable_page_source T>
+constexpr auto source_commit_fn() noexcept
+{
+    return +[](void* ptr, std::size_t size) noexcept -> bool { return T::commit(ptr, size); };
+}
+
+// forwards to a source owned elsewhere. used when several allocators draw from one stateful source
+template<page_source T>
+class source_ref
+{
+public:
+    explicit source_ref(T& source) noexcept : m_source(&source)
+    {}
+
+    static constexpr bool zeroed_pages = zeroing_page_source<T>;
+
+    void* alloc(std::size_t size, mem_flags flags) noexcept
+    {
+        return m_source->alloc(size, flags);
+    }
+    bool free(void* ptr, std::size_t size) noexcept
+    {
+        return m_source->free(ptr, size);
+    }
+    std::size_t page_size() const noexcept
+    {
+        return m_source->page_size();
+    }
+    std::size_t round_size(std::size_t size, mem_flags flags) const noexcept
+    {
+        return source_round_size(*m_source, size, flags);
+    }
+
+    static bool commit(void* ptr, std::size_t size) noexcept
+        requires committable_page_source<T>
+    {
+        return T::commit(ptr, size);
+    }
+    static bool decommit(void* ptr, std::size_t size) noexcept
+        requires committable_page_source<T>
+    {
+        return T::decommit(ptr, size);
+    }
+
+private:
+    T* m_source;
+};
+
+// stateless sources are shared by copying, stateful ones by reference
+template<page_source T>
+using shared_source_t = std::conditional_t<std::is_empty_v<T>, T, source_ref<T>>;
+
+template<page_source T>
+shared_source_t<T> share_source(T& source) noexcept
+{
+    if constexpr (std::is_empty_v<T>)
+        return T{};
+    else
+        return source_ref<T>(source);
+}
+
+// platform_mem with extra flags applied to every region
+template<mem_flags Textra>
+struct flagged_source
+{
+    using base_source = platform_mem;
+    static constexpr bool zeroed_pages = true;
+
+    static void* alloc(std::size_t size, mem_flags flags) noexcept
+    {
+        return platform_mem::alloc(size, flags | Textra);
+    }
+    static bool free(void* ptr, std::size_t size) noexcept
+    {
+        return platform_mem::free(ptr, size);
+    }
+    static std::size_t page_size() noexcept
+    {
+        return platform_mem::page_size();
+    }
+    static std::size_t round_size(std::size_t size, mem_flags flags) noexcept
+    {
+        return platform_mem::round_size(size, flags | Textra);
+    }
+    static bool commit(void* ptr, std::size_t size) noexcept
+    {
+        return platform_mem::commit(ptr, size);
+    }
+    static bool decommit(void* ptr, std::size_t size) noexcept
+    {
+        return platform_mem::decommit(ptr, size);
+    }
+};
+
+// carves page aligned regions out of a parent arena (see arena.h). free() is a no-op: the memory goes back when
+// the arena is reset or destroyed, so allocators nested in it are thrown away with it and never unmap anything.
+// costs up to one page of alignment padding per region.
+template<typename Tarena>
+class arena_source
+{
+public:
+    explicit arena_source(Tarena& parent) noexcept : m_arena(&parent)
+    {}
+
+    // honors populate / prefault (touch) and lock (mlock)
+    void* alloc(std::size_t size, mem_flags flags) noexcept
+    {
+        const std::size_t page = platform_mem::page_size();
+        auto* raw = static_cast<std::byte*>(m_arena->alloc(size + page - 1));
+        if (raw == nullptr)
+            return nullptr;
+
+        auto* ptr = reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(raw) + page - 1) & ~(std::uintptr_t(page) - 1));
+#ifndef _WIN32
+        if (has_flag(flags, mem_flags::lock) && mlock(ptr, size) != 0)
+            return nullptr;
+#endif
+        if (has_flag(flags, mem_flags::populate | mem_flags::prefault))
+            platform_mem::touch(ptr, size);
+        return ptr;
+    }
+    bool free(void*, std::size_t) noexcept
+    {
+        return true;
+    }
+    std::size_t page_size() const noexcept
+    {
+        return platform_mem::page_size();
+    }
+
+    Tarena& parent() const noexcept
+    {
+        return *m_arena;
+    }
+
+private:
+    Tarena* m_arena;
+};
+
+// every page is write-touched before the allocator sees it
+using prefault_source = flagged_source<mem_flags::prefault>;
+// 2 MiB aligned regions advised for transparent huge pages
+using huge_page_source = flagged_source<mem_flags::huge_pages>;
+
+// carves regions out of a caller-owned range: a static buffer, a shared segment, a block of a parent allocator.
+// regions are handed out in order at page granularity. free() only gives space back for the most recent region,
+// everything else is reclaimed when the caller releases the range. the range must outlive every allocator using it.
+class region_source
+{
+public:
+    region_source() noexcept = default;
+    // base is rounded up to a page boundary
+    region_source(void* base, std::size_t size) noexcept;
+
+    region_source(const region_source&) = delete;
+    region_source& operator=(const region_source&) = delete;
+    region_source(region_source&& other) noexcept;
+    region_source& operator=(region_source&& other) noexcept;
+
+    // honors populate / prefault (touch) and lock (mlock). returns nullptr once the range is exhausted
+    void* alloc(std::size_t size, mem_flags flags) noexcept;
+    bool free(void* ptr, std::size_t size) noexcept;
+    std::size_t page_size() const noexcept;
+
+    std::size_t get_used() const noexcept;
+    std::size_t get_capacity() const noexcept;
+
+private:
+    std::byte* m_begin = nullptr;
+    std::byte* m_cursor = nullptr;
+    std::byte* m_end = nullptr;
+};
+
+// every region is a MAP_SHARED window into one memfd, so the memory behind an allocator can be handed to another
+// process through fd() or mapped a second time. regions are carved from the file in order. freed regions are unmapped
+// but their file space is only returned when the source is destroyed. linux only.
+class memfd_source
+{
+public:
+    memfd_source() noexcept = default;
+    // capacity is rounded up to pages. throws std::bad_alloc if the memfd cannot be created
+    explicit memfd_source(std::size_t capacity, const char* name = "palloc-memfd");
+    ~memfd_source();
+
+    memfd_source(const memfd_source&) = delete;
+    memfd_source& operator=(const memfd_source&) = delete;
+    memfd_source(memfd_source&& other) noexcept;
+    memfd_source& operator=(memfd_source&& other) noexcept;
+
+    // honors populate, prefault and lock. returns nullptr once the file is exhausted
+    void* alloc(std::size_t size, mem_flags flags) noexcept;
+    bool free(void* ptr, std::size_t size) noexcept;
+    std::size_t page_size() const noexcept;
+
+    // file offset of the next region, i.e. where a region returned by the next alloc() starts in the file
+    std::size_t get_used() const noexcept;
+    std::size_t get_capacity() const noexcept;
+    int fd() const noexcept;
+
+private:
+    int m_fd = -1;
+    std::size_t m_used = 0;
+    std::size_t m_capacity = 0;
+};
+
+static_assert(page_source<region_source>);
+static_assert(page_source<memfd_source>);
+static_assert(committable_page_source<prefault_source>);
+static_assert(committable_page_source<source_ref<platform_mem>>);
+
+} // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/page_source.inl"
+#endif
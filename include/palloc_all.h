@@ -0,0 +1,25 @@
+#pragma once
+
+// single-include, header-only palloc: every allocator plus its implementation, no library to link.
+// the whole program must see the same PALLOC_HEADER_ONLY setting, so don't mix this with the palloc library.
+#ifndef PALLOC_HEADER_ONLY
+#define PALLOC_HEADER_ONLY
+#endif
+
+#include "platform.h"
+#include "page_source.h"
+#include "palloc_atomic.h"
+#include "pool_view.h"
+#include "pool.h"
+#include "arena.h"
+#include "double_arena.h"
+#include "thread_scratch.h"
+#include "radix_tree.h"
+#include "slab.h"
+#include "dynamic_slab.h"
+#include "coroutine_frame.h"
+#include "shared_block.h"
+#include "ring_buffer.h"
+#include "shm_segment.h"
+#include "shared_arena.h"
+#include "shared_pool.h"
@@ -43,6 +43,17 @@ struct palloc_atomic
         return old;
     }
 
+    bool compare_exchange_strong(T& expected, T desired, [[maybe_unused]] std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        if (value != expected)
+        {
+            expected = value;
+            return false;
+        }
+        value = desired;
+        return true;
+    }
+
     palloc_atomic& operator=(T v) noexcept
     {
         value = v;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "palloc_atomic.h"
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -9,6 +12,11 @@
 #include <unistd.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PALLOC_HAS_STREAM_STORES 1
+#endif
+
 inline constexpr bool palloc_is_windows =
 #ifdef _WIN32
     true;
@@ -26,17 +34,146 @@ inline constexpr bool palloc_is_windows =
 #define PALLOC_COLD
 #endif
 
+// PALLOC_HEADER_ONLY builds the implementation in include/impl/ into every including TU instead of the palloc
+// library, so pool and radix tree calls can inline without LTO. define it for the whole program or not at all.
+#ifdef PALLOC_HEADER_ONLY
+#define PALLOC_INLINE inline
+#else
+#define PALLOC_INLINE
+#endif
+
+// forces the small hot path into the caller so its speed does not depend on inliner heuristics or LTO.
+#if defined(__GNUC__) || defined(__clang__)
+#define PALLOC_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define PALLOC_ALWAYS_INLINE __forceinline
+#else
+#define PALLOC_ALWAYS_INLINE inline
+#endif
+
 namespace AL
 {
 
+// flags accepted by platform_mem::alloc. combine with operator|.
+// all of them trade startup time for the guarantee that the first touch of a page never faults later.
+enum class mem_flags : unsigned
+{
+    none = 0,
+    populate = 1u << 0, // pre-populate page tables at map time (MAP_POPULATE)
+    lock = 1u << 1,     // pin pages in RAM (MAP_LOCKED + mlock). fails if RLIMIT_MEMLOCK is too small
+    prefault = 1u << 2, // write-touch every page after mapping
+    // reserve address space only (PROT_NONE). the owner commits pages as it uses them, other flags are ignored.
+    // only pool and slab regions honor this. allocators that cannot commit on demand strip it.
+    lazy_commit = 1u << 3,
+    huge_pages = 1u << 4, // 2 MiB aligned region advised with MADV_HUGEPAGE (transparent huge pages)
+    huge_tlb = 1u << 5,   // MAP_HUGETLB from the reserved hugetlbfs pool, falls back to huge_pages when none are free
+};
+
+constexpr mem_flags operator|(mem_flags a, mem_flags b) noexcept
+{
+    return static_cast<mem_flags>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+
+constexpr mem_flags operator&(mem_flags a, mem_flags b) noexcept
+{
+    return static_cast<mem_flags>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+constexpr mem_flags operator~(mem_flags a) noexcept
+{
+    return static_cast<mem_flags>(~static_cast<unsigned>(a));
+}
+
+constexpr bool has_flag(mem_flags flags, mem_flags bit) noexcept
+{
+    return (flags & bit) != mem_flags::none;
+}
+
+// a stretch of work on the calling thread that must not map, unmap or reprotect memory, e.g. a trading session.
+// while one is open, platform_mem refuses on this thread: alloc, reserve, commit and decommit fail (nullptr / false),
+// free is queued until platform_mem::release_deferred() runs it, typically on a housekeeping thread.
+// every refusal is counted, so a slow path that would have needed the kernel shows up as a number to alert on.
+// scopes nest. prewarm() beforehand and no lazy_commit keep a well prepared session at zero refusals
+class no_syscall_scope
+{
+public:
+    no_syscall_scope() noexcept : m_start(thread_refusals())
+    {
+        ++depth();
+    }
+    ~no_syscall_scope() noexcept
+    {
+        --depth();
+    }
+
+    no_syscall_scope(const no_syscall_scope&) = delete;
+    no_syscall_scope& operator=(const no_syscall_scope&) = delete;
+
+    // refusals on this thread since this scope opened
+    std::size_t refusals() const noexcept
+    {
+        return thread_refusals() - m_start;
+    }
+
+    // true while the calling thread is inside a scope
+    static bool active() noexcept
+    {
+        return depth() != 0;
+    }
+
+    // refusals on the calling thread, and in the whole process, since startup
+    static std::size_t thread_refusals() noexcept
+    {
+        return thread_count();
+    }
+    static std::size_t total_refusals() noexcept
+    {
+        return total_count().load(std::memory_order_relaxed);
+    }
+
+    // counts one refusal. called by platform_mem and the page sources that map memory themselves
+    PALLOC_COLD static void refuse() noexcept
+    {
+        ++thread_count();
+        total_count().fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    static std::size_t& depth() noexcept
+    {
+        thread_local std::size_t value = 0;
+        return value;
+    }
+    static std::size_t& thread_count() noexcept
+    {
+        thread_local std::size_t value = 0;
+        return value;
+    }
+    static palloc_atomic<std::size_t>& total_count() noexcept
+    {
+        static palloc_atomic<std::size_t> value{0};
+        return value;
+    }
+
+    std::size_t m_start;
+};
+
 //
 // replaces platform specific system calls with a wrapper that changes which function is called based on what system you compiled for.
-// has zero runtime overhead
+// has zero runtime overhead beyond the thread local no_syscall_scope check
 //
 struct platform_mem
 {
+    static constexpr std::size_t huge_page_size = std::size_t(2) * 1024 * 1024;
+    // regions from alloc() and reserve() are fresh anonymous mappings and read as zero until written, see page_source.h
+    static constexpr bool zeroed_pages = true;
+    // zero() uses non-temporal stores from this size up
+    static constexpr std::size_t stream_zero_threshold = 4096;
+
     [[nodiscard]] static void* alloc(std::size_t size) noexcept
     {
+        if (no_syscall_scope::active()) [[unlikely]]
+            return refused();
 #ifdef _WIN32
         return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
 #else
@@ -45,16 +182,180 @@ struct platform_mem
 #endif
     }
 
-    static bool free(void* ptr, std::size_t size) noexcept
+    // same as alloc(size), but applies mem_flags so the mapping is resident before it is returned.
+    // returns nullptr if the mapping or the page lock fails.
+    [[nodiscard]] static void* alloc(std::size_t size, mem_flags flags) noexcept
     {
+        if (no_syscall_scope::active()) [[unlikely]]
+            return refused();
+        if (flags == mem_flags::none)
+            return alloc(size);
+        if (has_flag(flags, mem_flags::lazy_commit))
+            return reserve(size);
+
 #ifdef _WIN32
-        (void)size;
-        return VirtualFree(ptr, 0, MEM_RELEASE) != 0;
+        void* ptr = alloc(size);
+        if (ptr == nullptr)
+            return nullptr;
+        if (has_flag(flags, mem_flags::lock) && !VirtualLock(ptr, size))
+        {
+            free(ptr, size);
+            return nullptr;
+        }
 #else
-        return munmap(ptr, size) == 0;
+        if (has_flag(flags, mem_flags::huge_pages | mem_flags::huge_tlb))
+            return alloc_huge(size, flags);
+
+        int map_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+        if (has_flag(flags, mem_flags::populate))
+            map_flags |= MAP_POPULATE;
+#endif
+#ifdef MAP_LOCKED
+        if (has_flag(flags, mem_flags::lock))
+            map_flags |= MAP_LOCKED;
+#endif
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, map_flags, -1, 0);
+        if (ptr == MAP_FAILED)
+            return nullptr;
+
+        // MAP_LOCKED is best-effort, mlock reports whether the pages are actually pinned
+        if (has_flag(flags, mem_flags::lock) && mlock(ptr, size) != 0)
+        {
+            free(ptr, size);
+            return nullptr;
+        }
 #endif
+        if (has_flag(flags, mem_flags::prefault))
+            touch(ptr, size);
+        return ptr;
     }
 
+    // size granularity alloc(size, flags) expects: huge_page_size for huge page flags, page_size() otherwise.
+    // free() must be given the same rounded size.
+    static std::size_t granularity(mem_flags flags) noexcept
+    {
+        if (has_flag(flags, mem_flags::huge_pages | mem_flags::huge_tlb) && !has_flag(flags, mem_flags::lazy_commit))
+            return huge_page_size;
+        return page_size();
+    }
+
+    static std::size_t round_size(std::size_t size, mem_flags flags) noexcept
+    {
+        std::size_t unit = granularity(flags);
+        return ((size + unit - 1) / unit) * unit;
+    }
+
+    // bytes of [ptr, ptr + size) currently backed by huge pages (transparent or hugetlbfs), read from /proc/self/smaps.
+    // returns 0 where the information is unavailable.
+    static std::size_t huge_page_bytes(const void* ptr, std::size_t size) noexcept;
+
+    // reserves address space without charging any memory for it.
+    // pages are inaccessible until commit() is called on them. release with free().
+    [[nodiscard]] static void* reserve(std::size_t size) noexcept
+    {
+        if (no_syscall_scope::active()) [[unlikely]]
+            return refused();
+#ifdef _WIN32
+        return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+        void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+    }
+
+    // makes reserved pages readable and writable. ptr and size must be page aligned.
+    // committing an already committed page is a no-op.
+    static bool commit(void* ptr, std::size_t size) noexcept
+    {
+        if (no_syscall_scope::active()) [[unlikely]]
+        {
+            no_syscall_scope::refuse();
+            return false;
+        }
+#ifdef _WIN32
+        return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    // returns committed pages to the reserved state. their contents are discarded.
+    // refused inside a no_syscall_scope: deferring it would wipe the pages if the caller committed and reused them
+    static bool decommit(void* ptr, std::size_t size) noexcept
+    {
+        if (no_syscall_scope::active()) [[unlikely]]
+        {
+            no_syscall_scope::refuse();
+            return false;
+        }
+#ifdef _WIN32
+        return VirtualFree(ptr, size, MEM_DECOMMIT) != 0;
+#else
+        if (madvise(ptr, size, MADV_DONTNEED) != 0)
+            return false;
+        return mprotect(ptr, size, PROT_NONE) == 0;
+#endif
+    }
+
+    // maps the same `size` bytes twice, back to back: [p, p + size) and [p + size, p + 2 * size) alias the same pages,
+    // so any range of up to `size` bytes starting inside the first half is contiguous even across the wrap.
+    // size must be a multiple of page_size(). release with free_mirrored(). returns nullptr if unsupported or on failure.
+    [[nodiscard]] static void* alloc_mirrored(std::size_t size) noexcept
+    {
+        if (no_syscall_scope::active()) [[unlikely]]
+            return refused();
+#if defined(__linux__)
+        int fd = memfd_create("palloc-mirror", MFD_CLOEXEC);
+        if (fd < 0)
+            return nullptr;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        // reserve both halves first so nothing else can land between the two views
+        auto* base = static_cast<unsigned char*>(reserve(2 * size));
+        void* lo = base ? mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) : MAP_FAILED;
+        void* hi = lo != MAP_FAILED ? mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) : MAP_FAILED;
+        close(fd); // the mappings keep the memory alive
+
+        if (hi == MAP_FAILED)
+        {
+            if (base)
+                munmap(base, 2 * size);
+            return nullptr;
+        }
+        return base;
+#else
+        (void)size;
+        return nullptr;
+#endif
+    }
+
+    static bool free_mirrored(void* ptr, std::size_t size) noexcept
+    {
+        return free(ptr, 2 * size);
+    }
+
+    static bool free(void* ptr, std::size_t size) noexcept
+    {
+        if (no_syscall_scope::active()) [[unlikely]]
+            return defer_release(ptr, size);
+        return unmap(ptr, size);
+    }
+
+    // runs the frees refused inside no_syscall_scopes, from the calling thread.
+    // call it outside any scope, e.g. from a housekeeping thread. returns the number run
+    static std::size_t release_deferred() noexcept;
+    // refused frees waiting for release_deferred()
+    static std::size_t deferred_count() noexcept;
+    // bytes of refused frees that found the queue full. they stay mapped for the life of the process
+    static std::size_t leaked_bytes() noexcept;
+    // pending frees kept at most, past that a refused free is leaked (still counted as refused)
+    static constexpr std::size_t deferred_capacity = 1024;
+
     static std::size_t page_size() noexcept
     {
 #ifdef _WIN32
@@ -65,6 +366,123 @@ struct platform_mem
         return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
 #endif
     }
+
+#ifndef _WIN32
+    // size must be a multiple of huge_page_size
+    [[nodiscard]] static void* alloc_huge(std::size_t size, mem_flags flags) noexcept
+    {
+        if (no_syscall_scope::active()) [[unlikely]]
+            return refused();
+        void* ptr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+        if (has_flag(flags, mem_flags::huge_tlb))
+        {
+            int map_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_POPULATE
+            if (has_flag(flags, mem_flags::populate))
+                map_flags |= MAP_POPULATE;
+#endif
+            // fails when the hugetlbfs pool has no free pages. fall through to transparent huge pages
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, map_flags, -1, 0);
+        }
+#endif
+
+        if (ptr == MAP_FAILED)
+        {
+            // over-map by one huge page and trim both ends so the region starts on a 2 MiB boundary
+            void* raw = mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+                return nullptr;
+
+            auto raw_addr = reinterpret_cast<std::uintptr_t>(raw);
+            std::uintptr_t start = (raw_addr + huge_page_size - 1) & ~(std::uintptr_t(huge_page_size) - 1);
+            std::size_t head = start - raw_addr;
+            std::size_t tail = huge_page_size - head;
+            if (head != 0)
+                munmap(raw, head);
+            if (tail != 0)
+                munmap(reinterpret_cast<void*>(start + size), tail);
+
+            ptr = reinterpret_cast<void*>(start);
+#ifdef MADV_HUGEPAGE
+            madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+            // MAP_POPULATE would have faulted small pages before the advice, so populate by touching instead
+            if (has_flag(flags, mem_flags::populate))
+                flags = flags | mem_flags::prefault;
+        }
+
+        if (has_flag(flags, mem_flags::lock) && mlock(ptr, size) != 0)
+        {
+            free(ptr, size);
+            return nullptr;
+        }
+        if (has_flag(flags, mem_flags::prefault))
+            touch(ptr, size);
+        return ptr;
+    }
+#endif
+
+    // zeroes [ptr, ptr + size). large 64 byte aligned blocks are cleared with non-temporal stores,
+    // so clearing a page sized block does not evict the caller's working set from cache
+    static void zero(void* ptr, std::size_t size) noexcept
+    {
+#ifdef PALLOC_HAS_STREAM_STORES
+        if (size >= stream_zero_threshold && ((reinterpret_cast<std::uintptr_t>(ptr) | size) & 63) == 0)
+        {
+            const __m128i zeros = _mm_setzero_si128();
+            auto* out = static_cast<__m128i*>(ptr);
+            for (std::size_t i = 0; i < size / sizeof(__m128i); i += 4)
+            {
+                _mm_stream_si128(out + i, zeros);
+                _mm_stream_si128(out + i + 1, zeros);
+                _mm_stream_si128(out + i + 2, zeros);
+                _mm_stream_si128(out + i + 3, zeros);
+            }
+            // order the streamed stores before the block is handed out
+            _mm_sfence();
+            return;
+        }
+#endif
+        std::memset(ptr, 0, size);
+    }
+
+    // write-touches one byte per page without changing its contents, forcing every page to be backed.
+    static void touch(void* ptr, std::size_t size) noexcept
+    {
+        const std::size_t step = page_size();
+        auto* bytes = static_cast<volatile unsigned char*>(ptr);
+        for (std::size_t off = 0; off < size; off += step)
+            bytes[off] = bytes[off];
+    }
+
+private:
+    static bool unmap(void* ptr, std::size_t size) noexcept
+    {
+#ifdef _WIN32
+        (void)size;
+        return VirtualFree(ptr, 0, MEM_RELEASE) != 0;
+#else
+        return munmap(ptr, size) == 0;
+#endif
+    }
+
+    struct release_queue;
+    static release_queue& deferred_releases() noexcept;
+
+    PALLOC_COLD static void* refused() noexcept
+    {
+        no_syscall_scope::refuse();
+        return nullptr;
+    }
+    // queues a free refused inside a no_syscall_scope, or leaks it if the queue is full.
+    // returns true, the caller treats it as done
+    static bool defer_release(void* ptr, std::size_t size) noexcept;
 };
 
 } // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/platform.inl"
+#endif
@@ -1,15 +1,20 @@
 #pragma once
 
+#include "page_source.h"
 #include "palloc_atomic.h"
+#include "platform.h"
 #include "pool_view.h"
 #include <cstddef>
 #include <mutex>
 #include <new>
+#include <type_traits>
 
 namespace AL
 {
-template<typename Tconfig>
+template<typename Tconfig, page_source Tsource>
 class slab;
+struct thread_local_cache;
+struct intrusive_local_cache;
 
 #if defined(PALLOC_SINGLE_THREADED)
 struct pool_mutex
@@ -26,11 +31,20 @@ using pool_mutex = std::mutex;
 class alignas(std::hardware_destructive_interference_size) pool
 {
 public:
-    template<typename Tconfig>
+    template<typename Tconfig, page_source Tsource>
     friend class slab;
+    friend struct thread_local_cache;
+    friend struct intrusive_local_cache;
 
     pool();
-    pool(size_t block_size, size_t block_count);
+    pool(size_t block_size, size_t block_count, mem_flags flags = mem_flags::none);
+
+    template<typename Tsource>
+        requires page_source<std::remove_cvref_t<Tsource>>
+    pool(Tsource&& source, size_t block_size, size_t block_count, mem_flags flags = mem_flags::none) : pool()
+    {
+        init(std::forward<Tsource>(source), block_size, block_count, flags);
+    }
     ~pool();
 
     pool(const pool&) = delete;
@@ -38,12 +52,24 @@ public:
     pool(pool&&) noexcept;
     pool& operator=(pool&&) noexcept;
 
-    void init(size_t block_size, size_t block_count);
+    // flags control how the backing pages are mapped (see mem_flags)
+    void init(size_t block_size, size_t block_count, mem_flags flags = mem_flags::none);
+
+    // same as init, but the region comes from `source` (see page_source.h).
+    // stateless sources may be passed as temporaries, stateful ones are referenced and must outlive the pool.
+    template<typename Tsource>
+        requires page_source<std::remove_cvref_t<Tsource>>
+    void init(Tsource&& source, size_t block_size, size_t block_count, mem_flags flags = mem_flags::none);
 
     // non-owning initialization: the pool does not mmap or own the memory.
     // the caller (typically slab) is responsible for the lifetime of the region.
     // base must be aligned to at least block_size.
-    void init_from_region(void* base, size_t block_size, size_t block_count);
+    // zeroed: the region is known to read as zero, see pool_view::init_from_region
+    void init_from_region(void* base, size_t block_size, size_t block_count, bool zeroed = false);
+
+    // non-owning initialization over reserved (uncommitted) memory, see pool_view::init_from_reserved.
+    // throws std::bad_alloc if the bitmap pages cannot be committed.
+    void init_from_reserved(void* base, size_t block_size, size_t block_count, pool_view::commit_fn commit = &platform_mem::commit);
 
     // allocates a block of memory from the pool
     // returns properly aligned memory
@@ -52,12 +78,17 @@ public:
     [[nodiscard]] void* alloc();
 
     // allocates a block of memory from the pool
-    // also zeroes out the memory returned
+    // also zeroes out the memory returned, unless the block has never been used in a region that came zeroed from its source
     // returns properly aligned memory
     // thread-safe
     // returns: nullptr if failed, else the memory address of the block of memory
     [[nodiscard]] void* calloc();
 
+    // write-touches the pages under the next `count` blocks alloc() will hand out, so they take no page fault.
+    // thread-safe
+    // returns: the number of blocks covered, see pool_view::prefault
+    size_t prefault(size_t count);
+
     // frees the entire pool but keeps it alive to reuse
     // thread-safe
     void reset();
@@ -73,8 +104,13 @@ public:
     // gets the total amount of bytes that can be used by the pool
     size_t get_capacity() const;
 
+    // blocks never handed out since the region was mapped, calloc skips zeroing these
+    size_t get_pristine_count() const;
     size_t get_block_size() const;
     size_t get_block_count() const;
+    // bytes of the owned region currently backed by huge pages (see mem_flags::huge_pages).
+    // always 0 for pools initialized over a caller-provided region
+    size_t get_huge_page_bytes() const;
     void clear();
 
     std::byte* get_memory_start() const
@@ -87,8 +123,13 @@ public:
     }
 
 private:
+    // returns an owned region to the page source it came from
+    using release_fn = bool (*)(void* ctx, void* ptr, size_t size) noexcept;
+
     std::byte* m_region = nullptr; // owned mmap'd memory
     size_t m_region_size = 0;      // total mmap'd size (for munmap)
+    release_fn m_release = nullptr;
+    void* m_release_ctx = nullptr; // the source, for stateful sources
     pool_view m_view;              // bitmap-based allocator (non-owning)
     palloc_atomic<size_t> m_free_count{0};
     mutable pool_mutex m_mutex;
@@ -97,6 +138,55 @@ private:
     void check_asserts() const;
 
     size_t alloc_batched_internal(size_t num_objects, void* out[]);
-    void free_batched_internal(size_t num_objects, void* in[]);
+    // a never-used block (already zero), nullptr if none are left
+    void* alloc_pristine_internal();
+    void free_batched_internal(size_t num_objects, void* const in[]);
+
+    static size_t normalize_block_size(size_t block_size);
+    // takes ownership of a region fresh from a page source and carves the pool out of it.
+    // commit != nullptr means the region is only reserved. releases the region and throws std::bad_alloc on failure
+    void adopt_region(void* region, size_t region_size, release_fn release, void* release_ctx, size_t block_size, size_t block_count,
+                      pool_view::commit_fn commit, bool zeroed);
 };
+
+template<typename Tsource>
+    requires page_source<std::remove_cvref_t<Tsource>>
+void pool::init(Tsource&& source, size_t block_size, size_t block_count, mem_flags flags)
+{
+    using source_t = std::remove_cvref_t<Tsource>;
+    static_assert(std::is_empty_v<source_t> || std::is_lvalue_reference_v<Tsource>, "a stateful page source must outlive the pool, pass an lvalue");
+
+    block_size = normalize_block_size(block_size);
+    flags = source_flags<source_t>(flags);
+    size_t region_size = source_round_size(source, pool_view::required_region_size(block_size, block_count), flags);
+
+    void* ptr = source.alloc(region_size, flags);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+
+    release_fn release = nullptr;
+    void* release_ctx = nullptr;
+    if constexpr (std::is_empty_v<source_t>)
+    {
+        release = [](void*, void* region, size_t size) noexcept -> bool { return source_t{}.free(region, size); };
+    }
+    else
+    {
+        release = [](void* ctx, void* region, size_t size) noexcept -> bool { return static_cast<source_t*>(ctx)->free(region, size); };
+        release_ctx = &source;
+    }
+
+    pool_view::commit_fn commit = nullptr;
+    if constexpr (committable_page_source<source_t>)
+    {
+        if (has_flag(flags, mem_flags::lazy_commit))
+            commit = source_commit_fn<source_t>();
+    }
+
+    adopt_region(ptr, region_size, release, release_ctx, block_size, block_count, commit, zeroing_page_source<source_t>);
+}
 } // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/pool.inl"
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "platform.h"
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -10,28 +11,51 @@ namespace AL
 class pool_view
 {
 public:
+    // makes reserved pages accessible, see platform_mem::commit
+    using commit_fn = bool (*)(void* ptr, size_t size) noexcept;
+
     pool_view() noexcept = default;
 
     // region must hold at least required_region_size(block_size, block_count) bytes.
-    // base must be cache line aligned
-    void init_from_region(void* base, size_t block_size, size_t block_count) noexcept;
+    // base must be cache line aligned.
+    // zeroed: the payload is known to read as zero (e.g. fresh from mmap), so calloc can skip never-used blocks
+    void init_from_region(void* base, size_t block_size, size_t block_count, bool zeroed = false) noexcept;
+
+    // same as init_from_region, but the region is only reserved (see platform_mem::reserve).
+    // the bitmap is committed up front and payload pages are committed in chunks as the allocation frontier advances.
+    // committed pages stay committed across reset().
+    // commit is called for every newly committed range, it must match whatever reserved the region.
+    // returns false if the bitmap pages could not be committed. newly committed pages are taken to read as zero.
+    [[nodiscard]] bool init_from_reserved(void* base, size_t block_size, size_t block_count, commit_fn commit = &platform_mem::commit) noexcept;
 
     [[nodiscard]] void* alloc() noexcept;
+    // same as alloc(), is_zero tells whether the block has never been handed out from a zeroed region
+    [[nodiscard]] void* alloc(bool& is_zero) noexcept;
+    // only memsets blocks that have been handed out before
     [[nodiscard]] void* calloc() noexcept;
+    // takes the lowest never-used block, which reads as zero. nullptr if there is none (or the region was not zeroed)
+    [[nodiscard]] void* alloc_pristine() noexcept;
 
     // batch-allocate up to `count` blocks into out[].
     // returns the number actually allocated (may be < count if pool has fewer free blocks).
     // significantly faster than calling alloc() in a loop: single bitmap scan pass.
     [[nodiscard]] size_t alloc_batch(size_t count, void* out[]) noexcept;
 
+    // write-touches the pages under the next `count` blocks alloc() would hand out (the lowest free ones),
+    // committing them first in reserved mode. only bytes of free blocks are touched, and their contents are kept.
+    // returns the number of blocks covered, < count if the pool has fewer free blocks or a commit failed
+    size_t prefault(size_t count) noexcept;
+
     void free(void* ptr) noexcept;
-    void free_batch(std::span<void*> ptrs) noexcept;
+    void free_batch(std::span<void* const> ptrs) noexcept;
     void reset() noexcept;
 
     [[nodiscard]] size_t free_count() const noexcept;
     [[nodiscard]] size_t block_count() const noexcept;
     [[nodiscard]] size_t block_size() const noexcept;
     [[nodiscard]] size_t capacity() const noexcept;
+    // blocks that have never been handed out and read as zero
+    [[nodiscard]] size_t pristine_count() const noexcept;
     [[nodiscard]] bool owns(const void* ptr) const noexcept;
     [[nodiscard]] bool is_initialized() const noexcept;
     [[nodiscard]] std::byte* memory_start() const noexcept;
@@ -41,6 +65,9 @@ public:
     // includes bitmap + alignment padding + payload.
     [[nodiscard]] static size_t required_region_size(size_t block_size, size_t block_count) noexcept;
 
+    // payload pages committed per step in reserved mode
+    static constexpr size_t COMMIT_CHUNK = 64 * 1024;
+
 private:
     std::byte* m_memory = nullptr; // first payload block (after bitmap + padding)
     uint64_t* m_bitmap = nullptr;  // bitmap at start of region
@@ -50,6 +77,16 @@ private:
     size_t m_bitmap_words = 0;
     size_t m_hint = 0;       // first bitmap word that may have a free bit
     size_t m_block_shift = 0; // log2(m_block_size) — used for shift-based indexing
+    std::byte* m_commit_end = nullptr;  // blocks ending past this need commit_to(). == memory_end() when fully committed
+    std::byte* m_reserve_end = nullptr; // page-rounded end of the reserved region
+    commit_fn m_commit = nullptr;       // only set in reserved mode
+    std::byte* m_clean_floor = nullptr; // no block at or above this has been handed out. memory_end() if the region was not zeroed
+
+    [[nodiscard]] bool commit_to(std::byte* end) noexcept;
 };
 
 } // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/pool_view.inl"
+#endif
@@ -62,3 +62,7 @@ public:
 };
 
 } // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/radix_tree.inl"
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "arena.h"
+#include "platform.h"
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace AL
+{
+
+// single-producer / single-consumer allocator for variable-size records over a double-mapped region.
+// the region is mapped twice back to back (platform_mem::alloc_mirrored), so a record that starts near the end
+// continues in the mirror and is still one contiguous range. no record is ever split or copied.
+//
+// the producer allocates by bumping head, the consumer frees in FIFO order by advancing tail.
+// records are handed from producer to consumer by the caller (e.g. through an SPSC queue of pointers).
+// head and tail are always real atomics, even with PALLOC_SINGLE_THREADED, because producer and consumer are two threads.
+class ring_buffer
+{
+public:
+    // capacity is rounded up to a power of two multiple of the page size.
+    // throws std::bad_alloc if the mirrored mapping cannot be created.
+    explicit ring_buffer(size_t capacity)
+    {
+        size_t page_size = platform_mem::page_size();
+        capacity = capacity < page_size ? page_size : capacity;
+        m_capacity = std::bit_ceil(capacity);
+        m_mask = m_capacity - 1;
+
+        void* ptr = platform_mem::alloc_mirrored(m_capacity);
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        m_memory = static_cast<std::byte*>(ptr);
+    }
+
+    ~ring_buffer()
+    {
+        if (m_memory != nullptr)
+            platform_mem::free_mirrored(m_memory, m_capacity);
+    }
+
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator=(const ring_buffer&) = delete;
+    ring_buffer(ring_buffer&&) = delete;
+    ring_buffer& operator=(ring_buffer&&) = delete;
+
+    // producer only.
+    // returns: nullptr if the consumer has not freed enough space yet, else `length` contiguous bytes
+    // aligned to PALLOC_DEFAULT_ALIGNMENT
+    [[nodiscard]] void* alloc(size_t length)
+    {
+        if (length == 0 || length > max_record_size()) [[unlikely]]
+            return nullptr;
+
+        const uint64_t total = record_size(length);
+        const uint64_t h = m_head.load(std::memory_order_relaxed);
+        if (total > m_capacity - (h - m_tail.load(std::memory_order_acquire)))
+            return nullptr;
+
+        auto* rec = reinterpret_cast<record_header*>(m_memory + (h & m_mask));
+        rec->size = total;
+
+        // release publishes the header together with the new head
+        m_head.store(h + total, std::memory_order_release);
+        return reinterpret_cast<std::byte*>(rec) + HEADER_SIZE;
+    }
+
+    // consumer only. ptr must be the oldest record that has not been freed yet.
+    void free(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        auto* rec = reinterpret_cast<record_header*>(static_cast<std::byte*>(ptr) - HEADER_SIZE);
+        const uint64_t t = m_tail.load(std::memory_order_relaxed);
+        assert(m_memory + (t & m_mask) == reinterpret_cast<std::byte*>(rec) && "ring_buffer frees must be in FIFO order");
+
+        // release hands the record's bytes back to the producer
+        m_tail.store(t + rec->size, std::memory_order_release);
+    }
+
+    // bytes currently held by records, including headers and padding
+    size_t get_used() const
+    {
+        return static_cast<size_t>(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire));
+    }
+
+    size_t get_capacity() const
+    {
+        return m_capacity;
+    }
+
+    // largest length alloc() accepts
+    size_t max_record_size() const
+    {
+        return m_capacity - HEADER_SIZE;
+    }
+
+    // bytes one record of `length` consumes in the ring
+    static constexpr size_t record_size(size_t length)
+    {
+        return (HEADER_SIZE + length + PALLOC_DEFAULT_ALIGNMENT - 1) & ~(size_t(PALLOC_DEFAULT_ALIGNMENT) - 1);
+    }
+
+private:
+    struct record_header
+    {
+        uint64_t size; // header + payload + padding
+    };
+
+    static constexpr size_t HEADER_SIZE = PALLOC_DEFAULT_ALIGNMENT;
+    static_assert(sizeof(record_header) <= HEADER_SIZE);
+
+    std::byte* m_memory = nullptr;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+
+    alignas(std::hardware_destructive_interference_size) std::atomic<uint64_t> m_head{0}; // written by producer
+    alignas(std::hardware_destructive_interference_size) std::atomic<uint64_t> m_tail{0}; // written by consumer
+};
+
+} // namespace AL
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "arena.h"
+#include "shm_segment.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace AL
+{
+
+// arena living in a shared memory segment, usable from several processes at once.
+// all state sits in the segment itself and is addressed by offset, so every process may map it at a different address.
+// allocation is a single lock-free fetch_add on a process-shared atomic. always atomic, even with PALLOC_SINGLE_THREADED,
+// because the other side is a different process.
+template<size_t Talignment = PALLOC_DEFAULT_ALIGNMENT>
+class shared_arena
+{
+public:
+    // creates a new segment holding at least `bytes` of allocatable memory.
+    // name == nullptr creates an anonymous memfd that other processes attach to via fd().
+    // throws std::bad_alloc on failure.
+    static shared_arena create(size_t bytes, const char* name = nullptr)
+    {
+        shm_segment seg = shm_segment::create(DATA_OFFSET + bytes, name);
+        auto* hdr = std::construct_at(reinterpret_cast<header*>(seg.base()));
+        hdr->magic = MAGIC;
+        hdr->alignment = Talignment;
+        hdr->capacity = seg.size() - DATA_OFFSET;
+        hdr->used.store(0, std::memory_order_release);
+        return shared_arena(std::move(seg));
+    }
+
+    // attaches to a segment created by another shared_arena with the same alignment.
+    // throws std::bad_alloc on failure or if the segment was not created by a shared_arena.
+    static shared_arena open(const char* name)
+    {
+        return attach(shm_segment::open(name));
+    }
+
+    static shared_arena from_fd(int fd)
+    {
+        return attach(shm_segment::from_fd(fd));
+    }
+
+    // maps a snapshot() file copy-on-write, so a restart gets its warm data back without rebuilding it.
+    // only the pages touched are read, and changes stay in this process. such an arena has no fd() to share.
+    // throws std::bad_alloc on failure or if the file was not written by a shared_arena with the same alignment.
+    static shared_arena restore(const char* path)
+    {
+        return attach(shm_segment::restore(path));
+    }
+
+    shared_arena(shared_arena&&) noexcept = default;
+    shared_arena& operator=(shared_arena&&) noexcept = default;
+
+    [[nodiscard]] void* alloc(size_t length)
+    {
+        header* hdr = get_header();
+        if (length == 0 || length > hdr->capacity)
+            return nullptr;
+
+        size_t total_to_add = (length + Talignment - 1) & ~(Talignment - 1);
+        uint64_t offset = hdr->used.fetch_add(total_to_add, std::memory_order_relaxed);
+
+        if (offset >= hdr->capacity || total_to_add > hdr->capacity - offset)
+        {
+            hdr->used.fetch_sub(total_to_add, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        return data() + offset;
+    }
+
+    [[nodiscard]] void* calloc(size_t length)
+    {
+        void* ptr = alloc(length);
+        if (ptr != nullptr)
+            std::memset(ptr, 0, length);
+        return ptr;
+    }
+
+    // resets the arena for every attached process. caller must ensure no process still uses the memory.
+    void reset()
+    {
+        get_header()->used.store(0, std::memory_order_release);
+    }
+
+    // writes the header and the used bytes to path. store offsets (to_offset), not pointers, in the data: the
+    // restored arena is mapped elsewhere. no process may allocate meanwhile. returns false on failure
+    bool snapshot(const char* path) const
+    {
+        size_t used = get_used();
+        return m_segment.save(path, DATA_OFFSET + (used < get_capacity() ? used : get_capacity()));
+    }
+
+    // offset of ptr from the start of the segment. stable across processes.
+    uint64_t to_offset(const void* ptr) const
+    {
+        return static_cast<uint64_t>(static_cast<const std::byte*>(ptr) - m_segment.base());
+    }
+
+    // converts an offset produced by to_offset (in any process) back to a pointer in this mapping
+    void* from_offset(uint64_t offset) const
+    {
+        return m_segment.base() + offset;
+    }
+
+    size_t get_used() const
+    {
+        return get_header()->used.load(std::memory_order_relaxed);
+    }
+
+    size_t get_capacity() const
+    {
+        return get_header()->capacity;
+    }
+
+    int fd() const
+    {
+        return m_segment.fd();
+    }
+
+private:
+    static constexpr uint64_t MAGIC = 0x70616c6c6f634152; // "pallocAR"
+
+    struct header
+    {
+        uint64_t magic;
+        uint64_t alignment;
+        uint64_t capacity;
+        std::atomic<uint64_t> used;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "process-shared arena needs lock-free 64-bit atomics");
+
+    static constexpr size_t DATA_ALIGNMENT = Talignment > 64 ? Talignment : 64;
+    static constexpr size_t DATA_OFFSET = (sizeof(header) + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+
+    shm_segment m_segment;
+
+    explicit shared_arena(shm_segment&& seg) noexcept : m_segment(std::move(seg))
+    {}
+
+    static shared_arena attach(shm_segment&& seg)
+    {
+        if (seg.size() < DATA_OFFSET)
+            throw std::bad_alloc();
+        auto* hdr = reinterpret_cast<header*>(seg.base());
+        if (hdr->magic != MAGIC || hdr->alignment != Talignment || hdr->capacity != seg.size() - DATA_OFFSET)
+            throw std::bad_alloc();
+        return shared_arena(std::move(seg));
+    }
+
+    header* get_header() const
+    {
+        return reinterpret_cast<header*>(m_segment.base());
+    }
+
+    std::byte* data() const
+    {
+        return m_segment.base() + DATA_OFFSET;
+    }
+};
+
+} // namespace AL
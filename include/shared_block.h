@@ -0,0 +1,112 @@
+#pragma once
+
+#include "palloc_atomic.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace AL
+{
+
+// a block with an intrusive reference count in front of its payload, for handing one message to several consumers
+// without copying it. Towner is the allocator it came from: a pool, slab or dynamic_slab. the last release(), on any
+// thread, returns the block to the owner, which must outlive it. the header takes 16 bytes of the block.
+//
+//   auto* msg = AL::shared_block<AL::pool>::make(p, sizeof(Tick), consumers);   // one reference per consumer
+//   for (auto& q : queues) q.push(msg);
+//   ...
+//   use(msg->data());
+//   msg->release();                                                              // on each consumer
+template<typename Towner>
+class shared_block
+{
+public:
+    // allocates room for size bytes from owner, starting with `refs` references.
+    // handing out every reference up front saves one atomic per consumer over retain().
+    // returns: nullptr if the owner is out of memory or size does not fit the block
+    [[nodiscard]] static shared_block* make(Towner& owner, size_t size, uint32_t refs = 1)
+    {
+        static_assert(sizeof(shared_block) == 16, "the header keeps the payload 16 byte aligned");
+        if (refs == 0 || size > UINT32_MAX - sizeof(shared_block))
+            return nullptr;
+
+        const size_t bytes = sizeof(shared_block) + size;
+        void* mem = nullptr;
+        if constexpr (requires { owner.palloc(bytes); })
+        {
+            mem = owner.palloc(bytes);
+        }
+        else if constexpr (requires { owner.alloc(bytes); })
+        {
+            mem = owner.alloc(bytes);
+        }
+        else
+        {
+            if (bytes > owner.get_block_size())
+                return nullptr;
+            mem = owner.alloc();
+        }
+        if (mem == nullptr)
+            return nullptr;
+
+        return std::construct_at(static_cast<shared_block*>(mem), owner, static_cast<uint32_t>(bytes), refs);
+    }
+
+    // the block that data() returned p
+    static shared_block* from_data(void* p) noexcept
+    {
+        return static_cast<shared_block*>(p) - 1;
+    }
+
+    void* data() noexcept
+    {
+        return this + 1;
+    }
+    const void* data() const noexcept
+    {
+        return this + 1;
+    }
+
+    // adds references. the caller must already hold one
+    void retain(uint32_t count = 1) noexcept
+    {
+        m_refs.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // drops one reference. the last one frees the block, after every holder's reads and writes.
+    // returns: true if this call freed it
+    bool release()
+    {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return false;
+
+        Towner& owner = *m_owner;
+        const size_t bytes = m_bytes;
+        void* mem = this;
+        std::destroy_at(this);
+        if constexpr (requires { owner.free(mem, bytes); })
+            owner.free(mem, bytes);
+        else
+            owner.free(mem);
+        return true;
+    }
+
+    // a snapshot, only exact while no other thread holds a reference
+    uint32_t use_count() const noexcept
+    {
+        return m_refs.load(std::memory_order_relaxed);
+    }
+
+    shared_block(Towner& owner, uint32_t bytes, uint32_t refs) noexcept : m_owner(&owner), m_refs(refs), m_bytes(bytes)
+    {}
+
+    shared_block(const shared_block&) = delete;
+    shared_block& operator=(const shared_block&) = delete;
+
+private:
+    Towner* m_owner;
+    palloc_atomic<uint32_t> m_refs;
+    uint32_t m_bytes; // what was asked of the owner, header included
+};
+
+} // namespace AL
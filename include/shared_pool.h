@@ -0,0 +1,97 @@
+#pragma once
+
+#include "shm_segment.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AL
+{
+
+// fixed-size block pool living in a shared memory segment, usable from several processes at once.
+// the header, the bitmap and the payload all sit in the segment and are addressed by offset.
+// alloc claims a bit with a CAS on a process-shared bitmap word and free clears it with fetch_and,
+// so a block allocated in one process can be freed in another without copying and without locks.
+// always atomic, even with PALLOC_SINGLE_THREADED, because the other side is a different process.
+class shared_pool
+{
+public:
+    // creates a new segment for block_count blocks of block_size (rounded like pool::init).
+    // name == nullptr creates an anonymous memfd that other processes attach to via fd().
+    // throws std::bad_alloc on failure.
+    static shared_pool create(size_t block_size, size_t block_count, const char* name = nullptr);
+
+    // attaches to a segment created by shared_pool::create.
+    // throws std::bad_alloc on failure or if the segment was not created by a shared_pool.
+    static shared_pool open(const char* name);
+    static shared_pool from_fd(int fd);
+
+    // maps a snapshot() file copy-on-write, see shared_arena::restore.
+    // throws std::bad_alloc on failure or if the file was not written by a shared_pool.
+    static shared_pool restore(const char* path);
+
+    shared_pool(shared_pool&&) noexcept = default;
+    shared_pool& operator=(shared_pool&&) noexcept = default;
+
+    // lock-free. returns nullptr if the pool is exhausted
+    [[nodiscard]] void* alloc();
+    [[nodiscard]] void* calloc();
+
+    // lock-free. ptr may have been allocated by any attached process (translate it with from_offset first)
+    void free(void* ptr);
+
+    // writes the header, the bitmap and the payload up to the last allocated block to path. store offsets, not
+    // pointers, in the blocks. no process may alloc or free meanwhile. returns false on failure
+    bool snapshot(const char* path) const;
+
+    // offset of ptr from the start of the segment. stable across processes.
+    uint64_t to_offset(const void* ptr) const;
+
+    // converts an offset produced by to_offset (in any process) back to a pointer in this mapping
+    void* from_offset(uint64_t offset) const;
+
+    bool owns(const void* ptr) const;
+    size_t get_free_space() const;
+    size_t get_capacity() const;
+    size_t get_block_size() const;
+    size_t get_block_count() const;
+
+    int fd() const
+    {
+        return m_segment.fd();
+    }
+
+private:
+    struct header
+    {
+        uint64_t magic;
+        uint64_t block_size;
+        uint64_t block_shift;
+        uint64_t block_count;
+        uint64_t bitmap_words;
+        uint64_t payload_offset;
+        std::atomic<uint64_t> free_count;
+        std::atomic<uint64_t> hint; // first bitmap word that may have a free bit
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "process-shared pool needs lock-free 64-bit atomics");
+
+    static constexpr uint64_t MAGIC = 0x70616c6c6f63504c; // "pallocPL"
+    static constexpr size_t BITMAP_OFFSET = 64;
+    static_assert(sizeof(header) <= BITMAP_OFFSET);
+
+    shm_segment m_segment;
+
+    explicit shared_pool(shm_segment&& seg) noexcept;
+    static shared_pool attach(shm_segment&& seg);
+
+    header* get_header() const;
+    std::atomic<uint64_t>* get_bitmap() const;
+    std::byte* get_payload() const;
+};
+
+} // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/shared_pool.inl"
+#endif
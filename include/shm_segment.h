@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AL
+{
+
+// owning handle to a shared memory object mapped MAP_SHARED into this process.
+// the object is a memfd when created without a name, otherwise a POSIX shm_open object.
+// another process attaches by name (open) or by an inherited / passed file descriptor (from_fd).
+// the same object is usually mapped at different addresses in each process, so anything stored
+// inside it must be an offset from base(), never a raw pointer.
+class shm_segment
+{
+public:
+    shm_segment() noexcept = default;
+    ~shm_segment();
+
+    shm_segment(const shm_segment&) = delete;
+    shm_segment& operator=(const shm_segment&) = delete;
+    shm_segment(shm_segment&& other) noexcept;
+    shm_segment& operator=(shm_segment&& other) noexcept;
+
+    // creates a new zero-filled object of at least `size` bytes (rounded up to pages) and maps it.
+    // name == nullptr creates an anonymous memfd. a named object must not exist yet.
+    // throws std::bad_alloc on failure.
+    static shm_segment create(size_t size, const char* name = nullptr);
+
+    // maps an existing named object. throws std::bad_alloc on failure.
+    static shm_segment open(const char* name);
+
+    // maps the object behind fd. fd is duplicated, the caller keeps ownership of its copy.
+    // throws std::bad_alloc on failure.
+    static shm_segment from_fd(int fd);
+
+    // removes a named object. existing mappings stay valid.
+    static bool unlink(const char* name) noexcept;
+
+    // writes the first `bytes` of the mapping to a regular file, replacing it. the file is sized to size(),
+    // the rest is left as a hole that reads as zero and takes no disk space. returns false on failure
+    bool save(const char* path, size_t bytes) const noexcept;
+
+    // maps a file written by save() copy-on-write: pages are read from the file on first touch and writes stay
+    // private to this process, the file is never modified. there is no fd() to share, it returns -1.
+    // throws std::bad_alloc on failure.
+    static shm_segment restore(const char* path);
+
+    std::byte* base() const noexcept
+    {
+        return m_base;
+    }
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+    int fd() const noexcept
+    {
+        return m_fd;
+    }
+
+private:
+    std::byte* m_base = nullptr;
+    size_t m_size = 0;
+    int m_fd = -1;
+
+    void release() noexcept;
+    static shm_segment map_fd(int fd);
+};
+
+} // namespace AL
+
+#ifdef PALLOC_HEADER_ONLY
+#include "impl/shm_segment.inl"
+#endif
@@ -1,15 +1,21 @@
 #pragma once
 
+#include "arena.h"
+#include "page_source.h"
 #include "palloc_atomic.h"
 #include "platform.h"
 #include "pool.h"
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <new>
+#include <type_traits>
+#include <utility>
 
 namespace AL
 {
@@ -51,6 +57,16 @@ consteval bool is_valid_config(const auto& arr) noexcept
     return true;
 }
 
+// how a thread keeps the blocks it has cached for one size class
+//   array:     a fixed 128-pointer array per class (about 1 KiB each), holds up to 128 blocks
+//   intrusive: a list threaded through the cached blocks, three words per class. holds up to two batches,
+//              every cached class needs blocks of at least sizeof(void*)
+enum class tlc_storage
+{
+    array,
+    intrusive
+};
+
 template<std::size_t Tnum = 10,
          std::array<size_class, Tnum> Tsize_class_config =
              {
@@ -65,10 +81,13 @@ template<std::size_t Tnum = 10,
                  size_class{.byte_size = 2048,  .num_blocks = 32,  .batch_size = 4},
                  size_class{.byte_size = 4096,  .num_blocks = 32,  .batch_size = 4}
 },
-         std::size_t Tnum_cached_classes = Tnum>
+         std::size_t Tnum_cached_classes = Tnum,
+         std::size_t Tspill_classes = 0,
+         tlc_storage Ttlc_storage = tlc_storage::array>
 struct slab_config
 {
     static_assert(Tnum_cached_classes <= Tnum, "NUM_CACHED_CLASSES must be <= total size-class count");
+    static_assert(Tspill_classes < Tnum, "SPILL_CLASSES must be < total size-class count");
 
     static_assert(Tnum > 0, "at least one size class required");
     static_assert(is_valid_config(Tsize_class_config),
@@ -77,6 +96,10 @@ struct slab_config
     inline static constexpr std::array<size_class, Tnum> SIZE_CLASS_CONFIG = Tsize_class_config;
     static constexpr std::size_t NUM_SIZE_CLASSES = Tnum;
     static constexpr std::size_t NUM_CACHED_CLASSES = Tnum_cached_classes;
+    // when a class is exhausted, alloc tries up to this many larger classes before failing
+    // (or, in dynamic_slab, before growing). free routes spilled blocks back to the class they came from
+    static constexpr std::size_t SPILL_CLASSES = Tspill_classes;
+    static constexpr tlc_storage TLC_STORAGE = Ttlc_storage;
 
     static constexpr std::size_t INDEX_SPAN =
         std::bit_width(Tsize_class_config[Tnum - 1].byte_size) -
@@ -125,6 +148,10 @@ struct slab_config
         }
         return total;
     }
+
+    // a region base aligned to this keeps every pool aligned to its block size
+    static constexpr std::size_t REGION_ALIGNMENT =
+        Tsize_class_config[Tnum - 1].byte_size > 64 ? Tsize_class_config[Tnum - 1].byte_size : std::size_t(64);
 };
 
 struct thread_local_cache
@@ -163,18 +190,265 @@ struct thread_local_cache
         return current == object_count;
     }
 
+    size_t count() const
+    {
+        return current;
+    }
+
+    size_t capacity() const
+    {
+        return object_count;
+    }
+
+    // write-touches the pages under every cached block, contents unchanged
+    void touch(size_t block_size) const
+    {
+        for (size_t i = 0; i < current; ++i)
+            platform_mem::touch(objects[i], block_size);
+    }
+
     void invalidate()
     {
         current = 0;
     }
+
+    // takes up to n more blocks from the pool, never past capacity()
+    void fill(pool& p, size_t n)
+    {
+        const size_t room = object_count - current;
+        current += p.alloc_batched_internal(n < room ? n : room, objects.data() + current);
+    }
+
+    // returns the top batch of a full cache to the pool
+    void release_batch(pool& p)
+    {
+        p.free_batched_internal(batch_size, objects.data() + (current - batch_size));
+        current -= batch_size;
+    }
+
+    void release_all(pool& p)
+    {
+        if (current == 0)
+            return;
+        p.free_batched_internal(current, objects.data());
+        current = 0;
+    }
+
+    // pops up to n blocks into out[], top first. returns how many
+    size_t take(void* out[], size_t n)
+    {
+        size_t taken = current < n ? current : n;
+        for (size_t i = 0; i < taken; ++i)
+            out[i] = objects[--current];
+        return taken;
+    }
+
+    // caches ptrs from the front until full, skipping nullptr. returns how many entries were consumed
+    size_t absorb(void* const ptrs[], size_t n)
+    {
+        size_t i = 0;
+        for (; i < n && !is_full(); ++i)
+        {
+            if (ptrs[i] != nullptr)
+                push(ptrs[i]);
+        }
+        return i;
+    }
+};
+
+// the same cache threaded through the cached blocks: each one holds the pointer to the next.
+// pushes and pops work at the head, batches are spliced in at the tail so blocks cached earlier come out first
+struct intrusive_local_cache
+{
+    struct node
+    {
+        node* next;
+    };
+
+    // pointers moved per pool call
+    static constexpr size_t chunk_size = 128;
+
+    node* head = nullptr;
+    node* tail = nullptr; // only valid while count != 0
+    uint32_t cached = 0;
+    uint32_t batch_size = 1; // filled by slab on cache init
+
+    [[nodiscard]] void* try_pop()
+    {
+        node* n = head;
+        if (n == nullptr)
+            return nullptr;
+
+        head = n->next;
+        cached--;
+        return n;
+    }
+
+    void push(void* ptr)
+    {
+        assert(!is_full() && "Thread local cache is full");
+
+        node* n = static_cast<node*>(ptr);
+        n->next = head;
+        tail = cached == 0 ? n : tail;
+        head = n;
+        cached++;
+    }
+
+    bool is_empty() const
+    {
+        return cached == 0;
+    }
+
+    bool is_full() const
+    {
+        return cached >= 2 * batch_size;
+    }
+
+    size_t count() const
+    {
+        return cached;
+    }
+
+    size_t capacity() const
+    {
+        return 2 * size_t(batch_size);
+    }
+
+    // write-touches the pages under every cached block, contents unchanged. the next pointer only covers the first
+    void touch(size_t block_size) const
+    {
+        for (node* n = head; n != nullptr; n = n->next)
+            platform_mem::touch(n, block_size);
+    }
+
+    void invalidate()
+    {
+        head = nullptr;
+        cached = 0;
+    }
+
+    // takes up to n more blocks from the pool, never past capacity()
+    void fill(pool& p, size_t n)
+    {
+        void* chunk[chunk_size];
+        const size_t room = capacity() - cached;
+        for (size_t want = n < room ? n : room; want != 0;)
+        {
+            const size_t asked = want < chunk_size ? want : chunk_size;
+            const size_t got = p.alloc_batched_internal(asked, chunk);
+            splice(chunk, got);
+            if (got < asked)
+                break;
+            want -= got;
+        }
+    }
+
+    // returns the top batch of a full cache to the pool
+    void release_batch(pool& p)
+    {
+        void* chunk[chunk_size];
+        for (size_t left = batch_size; left != 0;)
+        {
+            const size_t n = take(chunk, left < chunk_size ? left : chunk_size);
+            p.free_batched_internal(n, chunk);
+            left -= n;
+        }
+    }
+
+    void release_all(pool& p)
+    {
+        void* chunk[chunk_size];
+        while (size_t n = take(chunk, chunk_size))
+            p.free_batched_internal(n, chunk);
+    }
+
+    // pops up to n blocks into out[], head first. returns how many
+    size_t take(void* out[], size_t n)
+    {
+        size_t taken = 0;
+        for (; taken < n && head != nullptr; ++taken)
+        {
+            out[taken] = head;
+            head = head->next;
+        }
+        cached -= static_cast<uint32_t>(taken);
+        return taken;
+    }
+
+    // caches ptrs from the front until full, skipping nullptr. returns how many entries were consumed
+    size_t absorb(void* const ptrs[], size_t n)
+    {
+        const size_t room = capacity() - cached;
+        size_t i = 0;
+        size_t linked = 0;
+        node* first = nullptr;
+        node* last = nullptr;
+        for (; i < n && linked < room; ++i)
+        {
+            if (ptrs[i] == nullptr)
+                continue;
+            node* block = static_cast<node*>(ptrs[i]);
+            if (first == nullptr)
+                first = block;
+            else
+                last->next = block;
+            last = block;
+            linked++;
+        }
+        if (linked != 0)
+            splice(first, last, linked);
+        return i;
+    }
+
+private:
+    void splice(void* const ptrs[], size_t n)
+    {
+        if (n == 0)
+            return;
+        node* first = static_cast<node*>(ptrs[0]);
+        node* last = first;
+        for (size_t i = 1; i < n; ++i)
+        {
+            last->next = static_cast<node*>(ptrs[i]);
+            last = last->next;
+        }
+        splice(first, last, n);
+    }
+
+    // appends the chain first..last (n blocks) after the current tail
+    void splice(node* first, node* last, size_t n)
+    {
+        last->next = nullptr;
+        if (cached == 0)
+            head = first;
+        else
+            tail->next = first;
+        tail = last;
+        cached += static_cast<uint32_t>(n);
+    }
 };
 
-template<typename Tconfig>
+template<typename Tconfig, page_source Tsource = platform_mem>
 class slab
 {
 public:
     // scale is multiplied by the default number of blocks to allocate
     slab();
+
+    // flags control how the backing region is mapped (see mem_flags).
+    // source provides the region (see page_source.h)
+    explicit slab(mem_flags flags, Tsource source = Tsource{});
+
+    // non-owning: carves the pools out of [buffer, buffer + size) instead of mapping a region.
+    // the buffer needs at least required_buffer_size() bytes and must outlive the slab, which never releases it.
+    // throws std::bad_alloc if it is too small.
+    slab(void* buffer, size_t size);
+
+    // non-owning: carves the pools out of one chunk of the parent arena, no syscalls.
+    // the chunk goes back when the arena is reset or destroyed. throws std::bad_alloc if the arena is full.
+    template<size_t Talignment, page_source Tarena_source>
+    explicit slab(arena<Talignment, Tarena_source>& parent);
     ~slab();
 
     slab(const slab&) = delete;
@@ -184,10 +458,37 @@ public:
 
     // returns: nullptr if failed, else the memory address of the block of memory
     // returns memory is properly aligned
-    [[nodiscard]] void* alloc(size_t size);
+    // inlined fast path: size -> index -> pop from this thread's cache. everything else is in alloc_slow()
+    [[nodiscard]] PALLOC_ALWAYS_INLINE void* alloc(size_t size);
+
+    // compile-time size: the size class and cached-class checks resolve at compile time,
+    // leaving only the thread cache pop. fails to compile if Tsize has no size class
+    template<size_t Tsize>
+    [[nodiscard]] PALLOC_ALWAYS_INLINE void* alloc()
+    {
+        return alloc_class<class_index<Tsize>()>();
+    }
+
+    // compile-time size class index, see size_to_index
+    template<size_t Tindex>
+    [[nodiscard]] PALLOC_ALWAYS_INLINE void* alloc_class()
+    {
+        static_assert(Tindex < Tconfig::NUM_SIZE_CLASSES, "size class index out of range");
+        if constexpr (Tindex < Tconfig::NUM_CACHED_CLASSES)
+        {
+            if (cache_entry* entry = fast_cached_slab()) [[likely]]
+            {
+                if (void* elem = entry->storage[Tindex].try_pop()) [[likely]]
+                    return elem;
+            }
+        }
+        return alloc_slow(Tindex);
+    }
 
     // returns: nullptr if failed, else the memory address of the block of memory
-    // returns memory is properly aligned
+    // returns memory is properly aligned.
+    // classes of PRISTINE_CALLOC_MIN bytes and up take a never-used block from the pool while there is one,
+    // which is already zero. everything else is zeroed, large blocks with non-temporal stores (see platform_mem::zero)
     [[nodiscard]] void* calloc(size_t size);
 
     // NOT thread safe
@@ -195,7 +496,72 @@ public:
     void reset();
 
     // returns: -1 if failed
-    void free(void* ptr, size_t size);
+    // inlined fast path: size -> index -> push to this thread's cache. everything else is in free_slow()
+    PALLOC_ALWAYS_INLINE void free(void* ptr, size_t size);
+
+    // compile-time counterparts of free(ptr, size), see alloc<Tsize>()
+    template<size_t Tsize>
+    PALLOC_ALWAYS_INLINE void free(void* ptr)
+    {
+        free_class<class_index<Tsize>()>(ptr);
+    }
+
+    template<size_t Tindex>
+    PALLOC_ALWAYS_INLINE void free_class(void* ptr)
+    {
+        static_assert(Tindex < Tconfig::NUM_SIZE_CLASSES, "size class index out of range");
+        if constexpr (Tconfig::SPILL_CLASSES > 0 && Tindex + 1 < Tconfig::NUM_SIZE_CLASSES)
+        {
+            // the block may have spilled into a larger class
+            free_index(ptr, owning_index(ptr, Tindex));
+        }
+        else
+        {
+            if constexpr (Tindex < Tconfig::NUM_CACHED_CLASSES)
+            {
+                if (cache_entry* entry = fast_cached_slab()) [[likely]]
+                {
+                    local_cache& cache = entry->storage[Tindex];
+                    if (!cache.is_full()) [[likely]]
+                    {
+                        cache.push(ptr);
+                        return;
+                    }
+                }
+            }
+            free_slow(ptr, Tindex);
+        }
+    }
+
+    // allocates up to n blocks of `size` into out[], draining this thread's cache first and taking the rest
+    // from the pool in one batch (one lock). returns the number allocated, < n only if the pool ran out
+    [[nodiscard]] size_t alloc_bulk(size_t size, size_t n, void* out[]);
+
+    // frees n blocks of `size`: fills this thread's cache and returns the overflow to the pool in one batch.
+    // nullptr entries are skipped
+    void free_bulk(size_t size, void* const ptrs[], size_t n);
+
+    // records ptr in this thread's deferred-free buffer, nothing is returned to the slab yet. the buffer is shared by
+    // every slab of this type on the thread and drained by drain(), automatically when DEFERRED_CAPACITY entries
+    // are pending, and when the thread exits. it is mapped on first use; if that fails, ptr is freed right away
+    PALLOC_ALWAYS_INLINE void free_deferred(void* ptr, size_t size);
+
+    // releases every pointer this thread deferred, into this slab or any other of its type: grouped by slab and class,
+    // sorted by address and returned through the bulk paths. call at a quiescent point, e.g. the end of a tick.
+    // a slab must not be destroyed while another thread still has frees deferred into it
+    void drain();
+
+    // pointers this thread has deferred and not yet drained
+    size_t get_deferred_count();
+
+    // readies the calling thread for a burst, e.g. right before market open: for each class, the pages under the next
+    // per_class_counts[i] blocks are touched (committed first if lazily committed), and as many of those blocks as
+    // this thread's cache holds are moved into it. the next allocations then take no refill and no page fault.
+    // returns the number of blocks covered, < the sum of counts only where a pool has fewer free blocks
+    size_t prewarm(const std::array<size_t, Tconfig::NUM_SIZE_CLASSES>& per_class_counts);
+
+    // hands every block this thread's cache holds for this slab back to the pools, deferred frees included
+    void release_warm();
 
     // returns true if freed successfully, false if not owned by this slab
     bool free_unsized(void* ptr);
@@ -205,6 +571,11 @@ public:
     size_t get_total_free() const;
     size_t get_pool_block_size(size_t index) const;
     size_t get_pool_free_space(size_t index) const;
+    // bytes of the backing region currently backed by huge pages (see mem_flags::huge_pages)
+    size_t get_huge_page_bytes() const
+    {
+        return AL::platform_mem::huge_page_bytes(m_region, m_region_size);
+    }
 
     // check if pointer belongs to this slab
     bool owns(void* ptr) const;
@@ -213,6 +584,8 @@ public:
     std::byte* region_start() const { return m_region; }
     std::byte* region_end() const { return m_region + m_region_size; }
 
+    Tsource& get_source() noexcept { return m_source; }
+
     static constexpr size_t size_to_index(size_t size)
     {
         if (size == 0 || size > Tconfig::SIZE_CLASS_CONFIG[Tconfig::NUM_SIZE_CLASSES - 1].byte_size)
@@ -224,6 +597,20 @@ public:
         return Tconfig::INDEX_LUT[vi];
     }
 
+    // bytes a caller-provided buffer needs, including alignment slack
+    static constexpr size_t required_buffer_size()
+    {
+        return Tconfig::compute_total_region_size() + Tconfig::REGION_ALIGNMENT - 1;
+    }
+
+    template<size_t Tsize>
+    static consteval size_t class_index()
+    {
+        constexpr size_t index = size_to_index(Tsize);
+        static_assert(index != static_cast<size_t>(-1), "no size class in this config can hold Tsize bytes");
+        return index;
+    }
+
     static constexpr size_t index_to_size_class(size_t index)
     {
         if (index >= Tconfig::NUM_SIZE_CLASSES)
@@ -231,14 +618,33 @@ public:
         return Tconfig::SIZE_CLASS_CONFIG[index].byte_size;
     }
 
+    static constexpr size_t DEFERRED_CAPACITY = 256;
+    // below this, clearing a cached block is cheaper than the pool lock a pristine block costs
+    static constexpr size_t PRISTINE_CALLOC_MIN = 1024;
+
 private:
     constexpr static size_t MAX_CACHED_SLABS = 4;
 
+    using local_cache = std::conditional_t<Tconfig::TLC_STORAGE == tlc_storage::intrusive, intrusive_local_cache, thread_local_cache>;
+
+    static consteval bool fits_intrusive_cache()
+    {
+        for (size_t i = 0; i < Tconfig::NUM_CACHED_CLASSES; ++i)
+        {
+            auto const& sc = Tconfig::SIZE_CLASS_CONFIG[i];
+            if (sc.byte_size < sizeof(void*) || sc.batch_size > std::numeric_limits<uint32_t>::max() / 2)
+                return false;
+        }
+        return true;
+    }
+    static_assert(Tconfig::TLC_STORAGE != tlc_storage::intrusive || fits_intrusive_cache(),
+                  "intrusive TLC storage needs cached classes of at least sizeof(void*) bytes");
+
     struct cache_entry
     {
         size_t epoch;
-        slab<Tconfig>* owner;
-        std::array<thread_local_cache, Tconfig::NUM_CACHED_CLASSES> storage;
+        slab* owner;
+        std::array<local_cache, Tconfig::NUM_CACHED_CLASSES> storage;
 
         void flush()
         {
@@ -246,15 +652,7 @@ private:
                 return; // should we assert?
 
             for (size_t i = 0; i < Tconfig::NUM_CACHED_CLASSES; i++)
-            {
-                // move pointers to appropriate pool from storage?
-                auto& cache = storage[i];
-                if (cache.is_empty())
-                    continue;
-
-                owner->shared_pools[i].free_batched_internal(cache.current, cache.objects.data());
-                cache.current = 0;
-            }
+                storage[i].release_all(owner->shared_pools[i]);
         }
 
         void invalidate_all()
@@ -269,6 +667,43 @@ private:
 
     inline thread_local static std::array<cache_entry, MAX_CACHED_SLABS> caches{};
 
+    static_assert(sizeof(intrusive_local_cache) == 3 * sizeof(void*), "intrusive storage is three words per class");
+    static_assert(Tconfig::TLC_STORAGE != tlc_storage::intrusive ||
+                      sizeof(cache_entry) == (2 + 3 * Tconfig::NUM_CACHED_CLASSES) * sizeof(void*),
+                  "an intrusive cache entry is its epoch, its owner and three words per cached class");
+
+    struct deferred_free
+    {
+        slab* owner;
+        void* ptr;
+        size_t index;
+        size_t epoch; // the owner's epoch when deferred, a reset() since then already freed ptr
+    };
+
+    // this thread's pending deferred frees for every slab of this type, apart from the cache entries so evicting
+    // one never drains them. mapped on the first free_deferred(), a thread that never defers pays two words
+    struct deferred_buffer
+    {
+        deferred_free* entries = nullptr;
+        size_t count = 0;
+
+        static constexpr size_t BYTES = DEFERRED_CAPACITY * sizeof(deferred_free);
+
+        // at thread exit: what is still pending goes straight to the pools, this thread's cache is never flushed.
+        // left empty, other thread_local destructors may still drain() after it
+        ~deferred_buffer()
+        {
+            if (count != 0)
+                drain_deferred(false);
+            if (entries != nullptr)
+                platform_mem::free(entries, BYTES);
+            entries = nullptr;
+            count = 0;
+        }
+    };
+
+    inline thread_local static deferred_buffer deferred{};
+
     cache_entry* get_cached_slab()
     {
         assert(MAX_CACHED_SLABS != 0 && "Cannot get cached slab. Number of cached slabs is 0");
@@ -319,29 +754,163 @@ private:
             entry.storage[i].batch_size = Tconfig::SIZE_CLASS_CONFIG[i].batch_size;
     }
 
+    // this slab's entry in the preferred slot with a current epoch, nullptr if the slow path has to sort it out
+    PALLOC_ALWAYS_INLINE cache_entry* fast_cached_slab()
+    {
+        cache_entry& entry = caches[slab_id % MAX_CACHED_SLABS];
+        if (entry.owner == this && entry.epoch == epoch.load(std::memory_order_acquire)) [[likely]]
+            return &entry;
+        return nullptr;
+    }
+
+    // this thread's entry for this slab if it has one, never claims or evicts
+    cache_entry* find_cached_slab()
+    {
+        for (cache_entry& entry : caches)
+        {
+            if (entry.owner == this)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    // finds or claims this slab's cache entry and drops it if a reset() made it stale
+    cache_entry* synced_cached_slab()
+    {
+        cache_entry* entry = get_cached_slab();
+        size_t current_epoch = epoch.load(std::memory_order_acquire);
+        if (entry->epoch != current_epoch) [[unlikely]]
+        {
+            entry->invalidate_all();
+            entry->epoch = current_epoch;
+        }
+        return entry;
+    }
+
+    // the class whose pool holds ptr, starting from the class its size maps to.
+    // only larger classes are checked, and only as far as a spill can reach
+    PALLOC_ALWAYS_INLINE size_t owning_index(void* ptr, size_t index) const
+    {
+        const size_t last = index + Tconfig::SPILL_CLASSES < Tconfig::NUM_SIZE_CLASSES ? index + Tconfig::SPILL_CLASSES
+                                                                                      : Tconfig::NUM_SIZE_CLASSES - 1;
+        while (index < last && static_cast<std::byte*>(ptr) >= m_pool_ends[index])
+            ++index;
+        return index;
+    }
+
+    // cache miss, uncached class, invalid size, cache slot scan / eviction and refill, spill
+    PALLOC_COLD void* alloc_slow(size_t index);
+    // exact class only: thread cache (refilled from the pool) or the pool itself
+    void* alloc_from_class(size_t index);
+    size_t alloc_bulk_from_class(size_t index, size_t n, void* out[]);
+    // ptrs all belong to this class's pool (or are nullptr)
+    void free_bulk_to_class(cache_entry& entry, size_t index, void* const ptrs[], size_t n);
+    // maps this thread's deferred buffer. returns false if the mapping failed (e.g. inside a no_syscall_scope)
+    PALLOC_COLD static bool map_deferred();
+    // releases every free pending in this thread's deferred buffer, each to the slab that owns it.
+    // through that slab's thread cache, or with into_cache = false straight to its pools
+    PALLOC_COLD static void drain_deferred(bool into_cache = true);
+    // drops this thread's pending deferred frees into this slab, before it goes away
+    void discard_deferred();
+    // full cache, uncached class, invalid size, cache slot scan / eviction and overflow flush
+    PALLOC_COLD void free_slow(void* ptr, size_t index);
+    PALLOC_ALWAYS_INLINE void free_index(void* ptr, size_t index);
+
+    // lays the pools out over m_region. commit != nullptr means the region is only reserved
+    void carve_pools(pool_view::commit_fn commit);
+    // adopts a caller-owned buffer as m_region and carves it
+    void init_from_buffer(void* buffer, size_t size);
+
     palloc_atomic<size_t> epoch;
     std::array<pool, Tconfig::NUM_SIZE_CLASSES> shared_pools;
+    // end of each pool's sub-region, pools are laid out in class order. used to route spilled frees
+    std::array<std::byte*, Tconfig::NUM_SIZE_CLASSES> m_pool_ends{};
+    // cleared once a pool has handed out its last never-used block, so calloc stops asking
+    std::array<palloc_atomic<bool>, Tconfig::NUM_SIZE_CLASSES> m_has_pristine{};
 
     std::byte* m_region = nullptr;
     size_t m_region_size = 0;
+    bool m_owns_region = true; // false when built inside a caller buffer or arena
+    [[no_unique_address]] Tsource m_source;
 
     inline static palloc_atomic<size_t> next_slab_id{0};
     size_t slab_id;
 };
 
-template<typename Tconfig>
-slab<Tconfig>::slab() : epoch(0), slab_id(next_slab_id.fetch_add(1, std::memory_order_relaxed))
+template<typename Tconfig, page_source Tsource>
+slab<Tconfig, Tsource>::slab() : slab(mem_flags::none)
+{}
+
+template<typename Tconfig, page_source Tsource>
+slab<Tconfig, Tsource>::slab(mem_flags flags, Tsource source)
+    : epoch(0), m_source(std::move(source)), slab_id(next_slab_id.fetch_add(1, std::memory_order_relaxed))
 {
     constexpr size_t raw_size = Tconfig::compute_total_region_size();
-    size_t page_size = AL::platform_mem::page_size();
-    m_region_size = ((raw_size + page_size - 1) / page_size) * page_size;
+    flags = source_flags<Tsource>(flags);
+    m_region_size = source_round_size(m_source, raw_size, flags);
 
-    void* mem = AL::platform_mem::alloc(m_region_size);
+    void* mem = m_source.alloc(m_region_size, flags);
     if (mem == nullptr)
         throw std::bad_alloc();
 
     m_region = static_cast<std::byte*>(mem);
 
+    // lazily committed pools commit through the source that reserved the region
+    pool_view::commit_fn commit = nullptr;
+    if constexpr (committable_page_source<Tsource>)
+    {
+        if (has_flag(flags, mem_flags::lazy_commit))
+            commit = source_commit_fn<Tsource>();
+    }
+
+    try
+    {
+        carve_pools(commit);
+    }
+    catch (...)
+    {
+        m_source.free(m_region, m_region_size);
+        throw;
+    }
+}
+
+template<typename Tconfig, page_source Tsource>
+slab<Tconfig, Tsource>::slab(void* buffer, size_t size) : epoch(0), slab_id(next_slab_id.fetch_add(1, std::memory_order_relaxed))
+{
+    init_from_buffer(buffer, size);
+}
+
+template<typename Tconfig, page_source Tsource>
+template<size_t Talignment, page_source Tarena_source>
+slab<Tconfig, Tsource>::slab(arena<Talignment, Tarena_source>& parent) : epoch(0), slab_id(next_slab_id.fetch_add(1, std::memory_order_relaxed))
+{
+    void* chunk = parent.alloc(required_buffer_size());
+    if (chunk == nullptr)
+        throw std::bad_alloc();
+    init_from_buffer(chunk, required_buffer_size());
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::init_from_buffer(void* buffer, size_t size)
+{
+    constexpr uintptr_t mask = Tconfig::REGION_ALIGNMENT - 1;
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+    const uintptr_t aligned = (addr + mask) & ~mask;
+    if (buffer == nullptr || size < (aligned - addr) + Tconfig::compute_total_region_size())
+        throw std::bad_alloc();
+
+    m_region = reinterpret_cast<std::byte*>(aligned);
+    m_region_size = Tconfig::compute_total_region_size();
+    m_owns_region = false;
+    carve_pools(nullptr);
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::carve_pools(pool_view::commit_fn commit)
+{
+    // only a region fresh from a zeroing source is known to be zero, a caller buffer or arena chunk may be reused
+    const bool zeroed = m_owns_region && zeroing_page_source<Tsource>;
+
     // carve sub-regions for each pool
     std::byte* cursor = m_region;
     for (size_t i = 0; i < Tconfig::NUM_SIZE_CLASSES; ++i)
@@ -353,14 +922,21 @@ slab<Tconfig>::slab() : epoch(0), slab_id(next_slab_id.fetch_add(1, std::memory_
         addr = (addr + mask) & ~mask;
         cursor = reinterpret_cast<std::byte*>(addr);
 
-        shared_pools[i].init_from_region(cursor, sc.byte_size, sc.num_blocks);
+        if (commit != nullptr)
+            shared_pools[i].init_from_reserved(cursor, sc.byte_size, sc.num_blocks, commit);
+        else
+            shared_pools[i].init_from_region(cursor, sc.byte_size, sc.num_blocks, zeroed);
+        m_has_pristine[i].store(commit != nullptr || zeroed, std::memory_order_relaxed);
         cursor += pool_view::required_region_size(sc.byte_size, sc.num_blocks);
+        m_pool_ends[i] = cursor;
     }
 }
 
-template<typename Tconfig>
-slab<Tconfig>::~slab()
+template<typename Tconfig, page_source Tsource>
+slab<Tconfig, Tsource>::~slab()
 {
+    discard_deferred();
+
     // invalidate TLC entries for this slab
     const size_t preferred = slab_id % MAX_CACHED_SLABS;
     if (caches[preferred].owner == this)
@@ -384,152 +960,406 @@ slab<Tconfig>::~slab()
     }
 
     // munmap the single contiguous region (pools are non-owning, their destructors are no-ops)
-    if (m_region != nullptr)
+    if (m_region != nullptr && m_owns_region)
     {
-        AL::platform_mem::free(m_region, m_region_size);
+        m_source.free(m_region, m_region_size);
         m_region = nullptr;
     }
 }
 
-template<typename Tconfig>
-void* slab<Tconfig>::alloc(size_t size)
+template<typename Tconfig, page_source Tsource>
+PALLOC_ALWAYS_INLINE void* slab<Tconfig, Tsource>::alloc(size_t size)
 {
-    if (size == 0 || size == (size_t)-1) [[unlikely]]
-        return nullptr;
-    if (Tconfig::SIZE_CLASS_CONFIG[Tconfig::NUM_SIZE_CLASSES - 1].byte_size < size) [[unlikely]]
-        return nullptr;
-
-    size_t index = size_to_index(size);
-    if (index == (size_t)-1) [[unlikely]]
-        return nullptr;
-
-    pool& p = shared_pools[index];
-
+    // size_to_index maps 0 and oversized requests to -1, which also takes the slow path
+    const size_t index = size_to_index(size);
     if (index < Tconfig::NUM_CACHED_CLASSES) [[likely]]
     {
-        auto cached_entry = get_cached_slab();
-        thread_local_cache& cache = cached_entry->storage[index];
-        size_t current_epoch = epoch.load(std::memory_order_acquire);
-        if (cached_entry->epoch != current_epoch) [[unlikely]]
+        if (cache_entry* entry = fast_cached_slab()) [[likely]]
         {
-            cached_entry->invalidate_all();
-            cached_entry->epoch = current_epoch;
+            if (void* elem = entry->storage[index].try_pop()) [[likely]]
+                return elem;
         }
+    }
+    return alloc_slow(index);
+}
 
-        if (auto elem = cache.try_pop()) [[likely]]
-            return elem;
+template<typename Tconfig, page_source Tsource>
+PALLOC_COLD void* slab<Tconfig, Tsource>::alloc_slow(size_t index)
+{
+    if (index == (size_t)-1)
+        return nullptr;
 
-        size_t num_allocated = p.alloc_batched_internal(cache.batch_size, cache.objects.data());
-        cache.current = num_allocated;
-        return cache.try_pop();
-    }
-    else
+    void* ptr = alloc_from_class(index);
+    if constexpr (Tconfig::SPILL_CLASSES > 0)
     {
-        return p.alloc();
+        for (size_t k = 1; ptr == nullptr && k <= Tconfig::SPILL_CLASSES && index + k < Tconfig::NUM_SIZE_CLASSES; ++k)
+            ptr = alloc_from_class(index + k);
     }
+    return ptr;
 }
 
-template<typename Tconfig>
-void* slab<Tconfig>::calloc(size_t size)
+template<typename Tconfig, page_source Tsource>
+void* slab<Tconfig, Tsource>::alloc_from_class(size_t index)
 {
-    void* ptr = alloc(size);
-    if (ptr != nullptr)
+    pool& p = shared_pools[index];
+    if (index >= Tconfig::NUM_CACHED_CLASSES)
+        return p.alloc();
+
+    local_cache& cache = synced_cached_slab()->storage[index];
+    if (auto elem = cache.try_pop())
+        return elem;
+
+    cache.fill(p, cache.batch_size);
+    return cache.try_pop();
+}
+
+template<typename Tconfig, page_source Tsource>
+void* slab<Tconfig, Tsource>::calloc(size_t size)
+{
+    const size_t index = size_to_index(size);
+    if (index == (size_t)-1)
+        return nullptr;
+
+    const size_t block_size = Tconfig::SIZE_CLASS_CONFIG[index].byte_size;
+    if (block_size >= PRISTINE_CALLOC_MIN && m_has_pristine[index].load(std::memory_order_relaxed))
     {
-        size_t actual_size = Tconfig::SIZE_CLASS_CONFIG[size_to_index(size)].byte_size;
-        std::memset(ptr, 0, actual_size);
+        if (void* ptr = shared_pools[index].alloc_pristine_internal())
+            return ptr;
+        // only for good once they are used up, a refused commit (e.g. in a no_syscall_scope) may succeed later
+        if (shared_pools[index].get_pristine_count() == 0)
+            m_has_pristine[index].store(false, std::memory_order_relaxed);
     }
+
+    void* ptr = alloc(size);
+    if (ptr != nullptr)
+        platform_mem::zero(ptr, block_size);
     return ptr;
 }
 
-template<typename Tconfig>
-void slab<Tconfig>::reset()
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::reset()
 {
     for (auto& p : shared_pools)
         p.reset();
     epoch.fetch_add(1, std::memory_order_release);
 }
 
-template<typename Tconfig>
-void slab<Tconfig>::free(void* ptr, size_t size)
+template<typename Tconfig, page_source Tsource>
+PALLOC_ALWAYS_INLINE void slab<Tconfig, Tsource>::free(void* ptr, size_t size)
+{
+    size_t index = size_to_index(size);
+    if constexpr (Tconfig::SPILL_CLASSES > 0)
+    {
+        if (index != (size_t)-1)
+            index = owning_index(ptr, index);
+    }
+    free_index(ptr, index);
+}
+
+template<typename Tconfig, page_source Tsource>
+PALLOC_ALWAYS_INLINE void slab<Tconfig, Tsource>::free_index(void* ptr, size_t index)
 {
-    if (size == 0 || size == (size_t)-1) [[unlikely]]
+    if (index < Tconfig::NUM_CACHED_CLASSES) [[likely]]
+    {
+        if (cache_entry* entry = fast_cached_slab()) [[likely]]
+        {
+            local_cache& cache = entry->storage[index];
+            if (!cache.is_full()) [[likely]]
+            {
+                cache.push(ptr);
+                return;
+            }
+        }
+    }
+    free_slow(ptr, index);
+}
+
+template<typename Tconfig, page_source Tsource>
+PALLOC_COLD void slab<Tconfig, Tsource>::free_slow(void* ptr, size_t index)
+{
+    if (index == (size_t)-1)
         return;
-    if (Tconfig::SIZE_CLASS_CONFIG[Tconfig::NUM_SIZE_CLASSES - 1].byte_size < size) [[unlikely]]
+
+    pool& p = shared_pools[index];
+    if (index >= Tconfig::NUM_CACHED_CLASSES)
+    {
+        p.free(ptr);
         return;
+    }
 
-    size_t index = size_to_index(size);
-    if (index == (size_t)-1) [[unlikely]]
+    local_cache& cache = synced_cached_slab()->storage[index];
+    if (cache.is_full())
+        cache.release_batch(p);
+    cache.push(ptr);
+}
+
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::alloc_bulk(size_t size, size_t n, void* out[])
+{
+    const size_t index = size_to_index(size);
+    if (index == (size_t)-1 || n == 0 || out == nullptr)
+        return 0;
+
+    size_t done = alloc_bulk_from_class(index, n, out);
+    if constexpr (Tconfig::SPILL_CLASSES > 0)
+    {
+        for (size_t k = 1; done < n && k <= Tconfig::SPILL_CLASSES && index + k < Tconfig::NUM_SIZE_CLASSES; ++k)
+            done += alloc_bulk_from_class(index + k, n - done, out + done);
+    }
+    return done;
+}
+
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::alloc_bulk_from_class(size_t index, size_t n, void* out[])
+{
+    pool& p = shared_pools[index];
+    if (index >= Tconfig::NUM_CACHED_CLASSES)
+        return p.alloc_batched_internal(n, out);
+
+    // the top of the cache is handed out first, same order as repeated alloc()
+    local_cache& cache = synced_cached_slab()->storage[index];
+    size_t from_cache = cache.take(out, n);
+
+    if (from_cache == n)
+        return n;
+    return from_cache + p.alloc_batched_internal(n - from_cache, out + from_cache);
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::free_bulk(size_t size, void* const ptrs[], size_t n)
+{
+    const size_t index = size_to_index(size);
+    if (index == (size_t)-1 || n == 0 || ptrs == nullptr)
+        return;
+
+    cache_entry& entry = *synced_cached_slab();
+    if constexpr (Tconfig::SPILL_CLASSES > 0)
+    {
+        // batch the runs that are in the exact class, spilled blocks go back one by one
+        size_t start = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (ptrs[i] == nullptr)
+                continue;
+            size_t owner = owning_index(ptrs[i], index);
+            if (owner == index)
+                continue;
+            free_bulk_to_class(entry, index, ptrs + start, i - start);
+            free_bulk_to_class(entry, owner, ptrs + i, 1);
+            start = i + 1;
+        }
+        free_bulk_to_class(entry, index, ptrs + start, n - start);
+    }
+    else
+    {
+        free_bulk_to_class(entry, index, ptrs, n);
+    }
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::free_bulk_to_class(cache_entry& entry, size_t index, void* const ptrs[], size_t n)
+{
+    if (n == 0)
         return;
 
     pool& p = shared_pools[index];
-    if (index < Tconfig::NUM_CACHED_CLASSES) [[likely]]
+    if (index >= Tconfig::NUM_CACHED_CLASSES)
     {
-        auto cached_entry = get_cached_slab();
-        thread_local_cache& cache = cached_entry->storage[index];
-        size_t current_epoch = epoch.load(std::memory_order_acquire);
-        if (cached_entry->epoch != current_epoch) [[unlikely]]
+        p.free_batched_internal(n, ptrs);
+        return;
+    }
+
+    local_cache& cache = entry.storage[index];
+    size_t i = cache.absorb(ptrs, n);
+    if (i < n)
+        p.free_batched_internal(n - i, ptrs + i);
+}
+
+template<typename Tconfig, page_source Tsource>
+PALLOC_ALWAYS_INLINE void slab<Tconfig, Tsource>::free_deferred(void* ptr, size_t size)
+{
+    const size_t index = size_to_index(size);
+    if (ptr == nullptr || index == (size_t)-1)
+        return;
+
+    deferred_buffer& buffer = deferred;
+    if (buffer.entries == nullptr) [[unlikely]]
+    {
+        // nowhere to keep it, free it now instead
+        if (!map_deferred())
         {
-            cached_entry->invalidate_all();
-            cached_entry->epoch = current_epoch;
+            free(ptr, size);
+            return;
         }
+    }
+    if (buffer.count == DEFERRED_CAPACITY) [[unlikely]]
+        drain_deferred();
+    buffer.entries[buffer.count++] = {this, ptr, index, epoch.load(std::memory_order_relaxed)};
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::drain()
+{
+    if (deferred.count != 0)
+        drain_deferred();
+}
+
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::get_deferred_count()
+{
+    const deferred_buffer& buffer = deferred;
+    const size_t current_epoch = epoch.load(std::memory_order_acquire);
+    size_t count = 0;
+    for (size_t i = 0; i < buffer.count; ++i)
+    {
+        if (buffer.entries[i].owner == this && buffer.entries[i].epoch == current_epoch)
+            ++count;
+    }
+    return count;
+}
+
+template<typename Tconfig, page_source Tsource>
+PALLOC_COLD bool slab<Tconfig, Tsource>::map_deferred()
+{
+    void* mem = platform_mem::alloc(deferred_buffer::BYTES);
+    if (mem == nullptr)
+        return false;
+    deferred.entries = static_cast<deferred_free*>(mem);
+    return true;
+}
+
+template<typename Tconfig, page_source Tsource>
+PALLOC_COLD void slab<Tconfig, Tsource>::drain_deferred(bool into_cache)
+{
+    deferred_buffer& buffer = deferred;
+    deferred_free* pending = buffer.entries;
 
-        if (cache.is_full()) [[unlikely]]
+    // drop what a reset() already freed and route spilled blocks to the class that holds them
+    size_t n = 0;
+    for (size_t i = 0; i < buffer.count; ++i)
+    {
+        deferred_free d = pending[i];
+        slab* owner = d.owner;
+        if (d.epoch != owner->epoch.load(std::memory_order_acquire))
+            continue;
+        if constexpr (Tconfig::SPILL_CLASSES > 0)
+            d.index = owner->owning_index(d.ptr, d.index);
+        pending[n++] = d;
+    }
+    buffer.count = 0;
+
+    // one run per slab and class for the bulk path, ascending addresses so each pool's bitmap is walked in order
+    std::sort(pending, pending + n, [](const deferred_free& a, const deferred_free& b) {
+        if (a.owner != b.owner)
+            return std::less<slab*>{}(a.owner, b.owner);
+        return a.index != b.index ? a.index < b.index : std::less<void*>{}(a.ptr, b.ptr);
+    });
+
+    std::array<void*, DEFERRED_CAPACITY> ptrs;
+    for (size_t i = 0; i < n; ++i)
+        ptrs[i] = pending[i].ptr;
+
+    size_t start = 0;
+    for (size_t i = 1; i <= n; ++i)
+    {
+        if (i == n || pending[i].owner != pending[start].owner || pending[i].index != pending[start].index)
         {
-            p.free_batched_internal(cache.batch_size, cache.objects.data() + (cache.current - cache.batch_size));
-            cache.current -= cache.batch_size;
+            slab* owner = pending[start].owner;
+            const size_t index = pending[start].index;
+            if (into_cache)
+                owner->free_bulk_to_class(*owner->synced_cached_slab(), index, ptrs.data() + start, i - start);
+            else
+                owner->shared_pools[index].free_batched_internal(i - start, ptrs.data() + start);
+            start = i;
         }
-        cache.push(ptr);
     }
-    else
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::discard_deferred()
+{
+    deferred_buffer& buffer = deferred;
+    size_t n = 0;
+    for (size_t i = 0; i < buffer.count; ++i)
     {
-        shared_pools[index].free(ptr);
+        if (buffer.entries[i].owner != this)
+            buffer.entries[n++] = buffer.entries[i];
     }
+    buffer.count = n;
 }
 
-template<typename Tconfig>
-bool slab<Tconfig>::free_unsized(void* ptr)
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::prewarm(const std::array<size_t, Tconfig::NUM_SIZE_CLASSES>& per_class_counts)
 {
+    size_t covered = 0;
     for (size_t i = 0; i < Tconfig::NUM_SIZE_CLASSES; ++i)
     {
+        const size_t want = per_class_counts[i];
+        if (want == 0)
+            continue;
+
         pool& p = shared_pools[i];
-        if (p.owns(ptr))
+        if (i >= Tconfig::NUM_CACHED_CLASSES)
         {
-            if (i < Tconfig::NUM_CACHED_CLASSES) [[likely]]
-            {
-                auto cached_entry = get_cached_slab();
-                thread_local_cache& cache = cached_entry->storage[i];
-                size_t current_epoch = epoch.load(std::memory_order_acquire);
-                if (cached_entry->epoch != current_epoch) [[unlikely]]
-                {
-                    cached_entry->invalidate_all();
-                    cached_entry->epoch = current_epoch;
-                }
+            covered += p.prefault(want);
+            continue;
+        }
 
-                if (cache.is_full()) [[unlikely]]
-                {
-                    p.free_batched_internal(cache.batch_size, cache.objects.data() + (cache.current - cache.batch_size));
-                    cache.current -= cache.batch_size;
-                }
-                cache.push(ptr);
-            }
-            else
-            {
-                p.free(ptr);
-            }
+        // a refill only claims blocks in the bitmap, so cached blocks may never have been written: touch them all.
+        // the pool hands out its lowest free blocks first, so the ones prefaulted here are the ones the cache takes next
+        local_cache& cache = synced_cached_slab()->storage[i];
+        cache.touch(Tconfig::SIZE_CLASS_CONFIG[i].byte_size);
+        const size_t cached = cache.count();
+        covered += cached >= want ? want : cached + p.prefault(want - cached);
+
+        const size_t target = want < cache.capacity() ? want : cache.capacity();
+        if (target > cached)
+            cache.fill(p, target - cached);
+    }
+    return covered;
+}
+
+template<typename Tconfig, page_source Tsource>
+void slab<Tconfig, Tsource>::release_warm()
+{
+    drain();
+    cache_entry* entry = find_cached_slab();
+    if (entry == nullptr)
+        return;
+
+    // a reset() since the blocks were cached already freed them
+    const size_t current_epoch = epoch.load(std::memory_order_acquire);
+    if (entry->epoch != current_epoch)
+    {
+        entry->invalidate_all();
+        entry->epoch = current_epoch;
+        return;
+    }
+    entry->flush();
+}
+
+template<typename Tconfig, page_source Tsource>
+bool slab<Tconfig, Tsource>::free_unsized(void* ptr)
+{
+    for (size_t i = 0; i < Tconfig::NUM_SIZE_CLASSES; ++i)
+    {
+        if (shared_pools[i].owns(ptr))
+        {
+            free_index(ptr, i);
             return true;
         }
     }
     return false;
 }
 
-template<typename Tconfig>
-size_t slab<Tconfig>::get_pool_count() const
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::get_pool_count() const
 {
     return std::size(shared_pools);
 }
 
-template<typename Tconfig>
-size_t slab<Tconfig>::get_total_capacity() const
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::get_total_capacity() const
 {
     size_t total = 0;
     for (const auto& p : shared_pools)
@@ -537,8 +1367,8 @@ size_t slab<Tconfig>::get_total_capacity() const
     return total;
 }
 
-template<typename Tconfig>
-size_t slab<Tconfig>::get_total_free() const
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::get_total_free() const
 {
     size_t total = 0;
     for (const auto& p : shared_pools)
@@ -546,24 +1376,24 @@ size_t slab<Tconfig>::get_total_free() const
     return total;
 }
 
-template<typename Tconfig>
-size_t slab<Tconfig>::get_pool_block_size(size_t index) const
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::get_pool_block_size(size_t index) const
 {
     if (index >= Tconfig::NUM_SIZE_CLASSES)
         return 0;
     return shared_pools[index].get_block_size();
 }
 
-template<typename Tconfig>
-size_t slab<Tconfig>::get_pool_free_space(size_t index) const
+template<typename Tconfig, page_source Tsource>
+size_t slab<Tconfig, Tsource>::get_pool_free_space(size_t index) const
 {
     if (index >= Tconfig::NUM_SIZE_CLASSES)
         return 0;
     return shared_pools[index].get_free_space();
 }
 
-template<typename Tconfig>
-bool slab<Tconfig>::owns(void* ptr) const
+template<typename Tconfig, page_source Tsource>
+bool slab<Tconfig, Tsource>::owns(void* ptr) const
 {
     for (const auto& p : shared_pools)
         if (p.owns(ptr))
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "arena.h"
+#include "page_source.h"
+#include "platform.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace AL
+{
+
+// per-thread scratch memory for short-lived, strictly LIFO work such as a request handler.
+// each thread lazily gets its own growable arena: a chain of chunks of at least Tchunk_bytes, bumped without atomics.
+// reached through static functions, so no allocator has to be passed around. a scope remembers the bump position
+// and rewinds to it on exit, keeping the chunks it grew for the next request:
+//
+//   AL::default_thread_scratch::scope s;
+//   auto* buf = static_cast<char*>(AL::default_thread_scratch::alloc(len));
+//
+// memory from alloc() must not be passed to, or freed on, another thread. trim() unmaps spare chunks past
+// Tretain_bytes, call it when the thread goes idle. everything is unmapped when the thread exits.
+template<size_t Talignment = PALLOC_DEFAULT_ALIGNMENT, size_t Tchunk_bytes = 64 * 1024, size_t Tretain_bytes = Tchunk_bytes, page_source Tsource = platform_mem>
+class thread_scratch
+{
+    static_assert((Talignment & (Talignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(std::is_default_constructible_v<Tsource>, "every thread default constructs its own source");
+
+    struct chunk
+    {
+        chunk* next;
+        size_t size; // bytes mapped, header included
+    };
+
+    // the header is padded so the first block keeps the chunk's (page) alignment
+    static constexpr size_t HEADER_BYTES = (sizeof(chunk) + Talignment - 1) & ~(Talignment - 1);
+
+public:
+    // where the bump pointer was. current is nullptr before the first allocation
+    struct marker
+    {
+        chunk* current;
+        std::byte* cursor;
+        size_t used;
+    };
+
+    // rewinds to where it was constructed. scopes nest, and must be destroyed in reverse order
+    class scope
+    {
+    public:
+        scope() noexcept : m_mark(thread_scratch::mark())
+        {}
+        ~scope()
+        {
+            thread_scratch::rewind(m_mark);
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        marker m_mark;
+    };
+
+    // returns: nullptr if length is 0 or the thread's source is out of memory, else Talignment aligned memory
+    [[nodiscard]] static void* alloc(size_t length)
+    {
+        if (length == 0)
+            return nullptr;
+
+        state& s = local();
+        size_t total_to_add = (length + Talignment - 1) & ~(Talignment - 1);
+        if (total_to_add < length || static_cast<size_t>(s.end - s.cursor) < total_to_add)
+            return alloc_slow(s, total_to_add);
+
+        void* ptr = s.cursor;
+        s.cursor += total_to_add;
+        s.used += total_to_add;
+        return ptr;
+    }
+
+    [[nodiscard]] static void* calloc(size_t length)
+    {
+        void* ptr = alloc(length);
+        if (ptr != nullptr)
+            std::memset(ptr, 0, length);
+        return ptr;
+    }
+
+    static marker mark() noexcept
+    {
+        const state& s = local();
+        return {s.current, s.cursor, s.used};
+    }
+
+    // frees everything allocated after m was taken. chunks stay mapped for reuse
+    static void rewind(const marker& m) noexcept
+    {
+        state& s = local();
+        s.current = m.current;
+        s.cursor = m.cursor;
+        s.end = m.current != nullptr ? reinterpret_cast<std::byte*>(m.current) + m.current->size : nullptr;
+        s.used = m.used;
+    }
+
+    // rewinds the calling thread to empty, as if every scope had exited
+    static void reset() noexcept
+    {
+        rewind({nullptr, nullptr, 0});
+    }
+
+    // unmaps this thread's chunks that hold no live allocation, keeping at most retain_bytes mapped in total
+    // (chunks in use always stay). returns the number of bytes unmapped
+    static size_t trim(size_t retain_bytes = Tretain_bytes)
+    {
+        state& s = local();
+        size_t kept = 0;
+        size_t released = 0;
+        bool spare = s.current == nullptr;
+        chunk** link = &s.head;
+        while (chunk* c = *link)
+        {
+            if (spare && kept + c->size > retain_bytes)
+            {
+                *link = c->next;
+                s.mapped -= c->size;
+                released += c->size;
+                s.source.free(c, c->size);
+                continue;
+            }
+            kept += c->size;
+            if (c == s.current)
+                spare = true;
+            link = &c->next;
+        }
+        return released;
+    }
+
+    // bytes handed out and not yet rewound on the calling thread, alignment padding included
+    static size_t get_used() noexcept
+    {
+        return local().used;
+    }
+
+    // bytes mapped for the calling thread, chunk headers included
+    static size_t get_capacity() noexcept
+    {
+        return local().mapped;
+    }
+
+private:
+    struct state
+    {
+        chunk* head = nullptr;    // chunks in bump order, the ones after current are spare
+        chunk* current = nullptr; // chunk being bumped, nullptr before the first allocation
+        std::byte* cursor = nullptr;
+        std::byte* end = nullptr;
+        size_t used = 0;
+        size_t mapped = 0;
+        [[no_unique_address]] Tsource source{};
+
+        ~state()
+        {
+            while (head != nullptr)
+            {
+                chunk* next = head->next;
+                source.free(head, head->size);
+                head = next;
+            }
+        }
+    };
+
+    static state& local() noexcept
+    {
+        thread_local state instance;
+        return instance;
+    }
+
+    // moves to the next spare chunk that fits, or maps a new one after current. the tail of current is skipped
+    PALLOC_COLD static void* alloc_slow(state& s, size_t total_to_add)
+    {
+        if (total_to_add > SIZE_MAX - HEADER_BYTES)
+            return nullptr;
+
+        chunk** link = s.current != nullptr ? &s.current->next : &s.head;
+        chunk* next = *link;
+        if (next == nullptr || next->size - HEADER_BYTES < total_to_add)
+        {
+            size_t wanted = HEADER_BYTES + total_to_add;
+            size_t size = source_round_size(s.source, wanted > Tchunk_bytes ? wanted : Tchunk_bytes, mem_flags::none);
+            void* mem = s.source.alloc(size, mem_flags::none);
+            if (mem == nullptr)
+                return nullptr;
+
+            // a too small spare stays behind the new chunk for later
+            next = static_cast<chunk*>(mem);
+            next->next = *link;
+            next->size = size;
+            *link = next;
+            s.mapped += size;
+        }
+
+        s.current = next;
+        s.cursor = reinterpret_cast<std::byte*>(next) + HEADER_BYTES + total_to_add;
+        s.end = reinterpret_cast<std::byte*>(next) + next->size;
+        s.used += total_to_add;
+        return reinterpret_cast<std::byte*>(next) + HEADER_BYTES;
+    }
+};
+
+using default_thread_scratch = thread_scratch<>;
+
+} // namespace AL
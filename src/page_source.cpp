@@ -0,0 +1,2 @@
+// library build of the implementation. with PALLOC_HEADER_ONLY it is included by page_source.h instead
+#include "impl/page_source.inl"
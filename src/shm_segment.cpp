@@ -0,0 +1,2 @@
+// library build of the implementation. with PALLOC_HEADER_ONLY it is included by shm_segment.h instead
+#include "impl/shm_segment.inl"
@@ -0,0 +1,315 @@
+// ═══════════════════════════════════════════════════════════════════════════════
+// Coroutine Pipeline — Frame Allocator Benchmark
+//
+// Models an async gateway where every inbound message runs through a chain of
+// C++20 coroutines: decode → validate → enrich → route. Each stage is its own
+// coroutine, so one message costs several frame allocations of different,
+// compiler-chosen sizes that are freed in LIFO order.
+//
+// Phase 1 runs the whole chain on one thread. Phase 2 hands the started tasks
+// to a worker thread, which resumes them and destroys their frames there
+// (cross-thread frees).
+//
+// Frame sources tested: default heap (operator new), AL::frame_promise
+// Mode: Single-threaded, then 1 producer + 1 worker
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "coroutine_frame.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace AL;
+using Clock = std::chrono::high_resolution_clock;
+using Duration = std::chrono::nanoseconds;
+
+inline void escape(void* p) { asm volatile("" : : "g"(p) : "memory"); }
+
+// ─── Test parameters ─────────────────────────────────────────────────────────
+
+static constexpr int DURATION_SECS = 5;
+static constexpr size_t LATENCY_CAPACITY = 2'000'000;
+static constexpr size_t HANDOFF_BATCH = 256;
+
+// ─── Task type, parameterized on where frames come from ──────────────────────
+
+struct heap_frame
+{};
+
+template<typename T, typename Tframe>
+class task
+{
+public:
+    struct promise_type : Tframe
+    {
+        T value{};
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        task get_return_object() { return task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept
+        {
+            struct resume_continuation
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+                {
+                    return h.promise().continuation;
+                }
+                void await_resume() noexcept {}
+            };
+            return resume_continuation{};
+        }
+        void return_value(T v) { value = v; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit task(std::coroutine_handle<promise_type> h) : m_handle(h) {}
+    task(task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    task& operator=(task&& other) noexcept
+    {
+        if (m_handle)
+            m_handle.destroy();
+        m_handle = std::exchange(other.m_handle, nullptr);
+        return *this;
+    }
+    ~task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        m_handle.promise().continuation = caller;
+        return m_handle;
+    }
+    T await_resume() { return m_handle.promise().value; }
+
+    T run()
+    {
+        m_handle.resume();
+        return m_handle.promise().value;
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// ─── Pipeline stages ─────────────────────────────────────────────────────────
+// locals that live across a suspension point end up in the frame, so the
+// stages have different frame sizes
+
+struct Message
+{
+    uint64_t sequence;
+    uint64_t symbol;
+    uint64_t price;
+    uint64_t quantity;
+};
+
+template<typename Tframe>
+task<uint64_t, Tframe> decode(uint64_t seq)
+{
+    Message m{seq, seq % 512, 10'000 + (seq % 977), 1 + (seq % 300)};
+    escape(&m);
+    co_return m.symbol * 31 + m.price * 7 + m.quantity;
+}
+
+template<typename Tframe>
+task<uint64_t, Tframe> validate(uint64_t seq)
+{
+    uint64_t limits[8] = {seq, seq + 1, seq + 2, seq + 3, seq + 4, seq + 5, seq + 6, seq + 7};
+    uint64_t decoded = co_await decode<Tframe>(seq);
+    escape(limits);
+    co_return decoded ^ limits[seq & 7];
+}
+
+template<typename Tframe>
+task<uint64_t, Tframe> enrich(uint64_t seq)
+{
+    uint64_t reference[24];
+    for (size_t i = 0; i < 24; ++i)
+        reference[i] = seq * (i + 1);
+    uint64_t checked = co_await validate<Tframe>(seq);
+    escape(reference);
+    co_return checked + reference[seq % 24];
+}
+
+template<typename Tframe>
+task<uint64_t, Tframe> route(uint64_t seq)
+{
+    uint64_t enriched = co_await enrich<Tframe>(seq);
+    uint64_t venue = co_await decode<Tframe>(enriched);
+    co_return enriched + venue % 4;
+}
+
+// ─── Latency recorder ───────────────────────────────────────────────────────
+
+struct LatencyRecorder
+{
+    std::vector<uint64_t> samples;
+    size_t idx = 0;
+
+    explicit LatencyRecorder(size_t cap) : samples(cap) {}
+
+    void record(uint64_t ns)
+    {
+        if (idx < samples.size()) samples[idx++] = ns;
+    }
+
+    struct Stats
+    {
+        uint64_t p50 = 0, p99 = 0, p999 = 0;
+    };
+
+    Stats compute()
+    {
+        if (idx == 0) return {};
+        std::sort(samples.begin(), samples.begin() + idx);
+        return {samples[idx * 50 / 100], samples[idx * 99 / 100], samples[idx * 999 / 1000]};
+    }
+};
+
+struct BenchResult
+{
+    const char* name;
+    size_t messages;
+    double elapsed_sec;
+    LatencyRecorder::Stats latency;
+};
+
+void print_results(const char* title, const std::vector<BenchResult>& results)
+{
+    printf("\n  %s\n", title);
+    printf("  %-22s %10s %10s %10s %10s %10s\n", "Frames", "ns/msg", "MOps/s", "p50", "p99", "p99.9");
+    printf("  ───────────────────────────────────────────────────────────────────────────\n");
+    for (const auto& r : results)
+    {
+        double ns = r.elapsed_sec * 1e9 / static_cast<double>(r.messages);
+        double mops = static_cast<double>(r.messages) / r.elapsed_sec / 1e6;
+        printf("  %-22s %10.1f %10.2f %10lu %10lu %10lu\n", r.name, ns, mops,
+               static_cast<unsigned long>(r.latency.p50), static_cast<unsigned long>(r.latency.p99),
+               static_cast<unsigned long>(r.latency.p999));
+    }
+}
+
+// ─── Phase 1: single thread ──────────────────────────────────────────────────
+
+template<typename Tframe>
+BenchResult run_single(const char* name)
+{
+    LatencyRecorder recorder(LATENCY_CAPACITY);
+    uint64_t seq = 0, checksum = 0;
+    size_t messages = 0;
+
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(DURATION_SECS);
+    while (Clock::now() < deadline)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            bool sample = (messages & 63) == 0;
+            auto t0 = sample ? Clock::now() : Clock::time_point{};
+
+            checksum += route<Tframe>(seq++).run();
+            messages++;
+
+            if (sample)
+                recorder.record(static_cast<uint64_t>(std::chrono::duration_cast<Duration>(Clock::now() - t0).count()));
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    escape(&checksum);
+    return {name, messages, elapsed, recorder.compute()};
+}
+
+// ─── Phase 2: producer starts tasks, worker resumes and destroys them ────────
+
+template<typename Tframe>
+BenchResult run_handoff(const char* name)
+{
+    using route_task = task<uint64_t, Tframe>;
+    std::vector<route_task> slots[2];
+    std::atomic<int> ready{-1};
+    std::atomic<bool> done{false};
+    std::atomic<size_t> processed{0};
+    LatencyRecorder recorder(LATENCY_CAPACITY);
+
+    std::thread worker([&] {
+        uint64_t checksum = 0;
+        while (true)
+        {
+            int slot = ready.load(std::memory_order_acquire);
+            if (slot < 0)
+            {
+                if (done.load(std::memory_order_acquire))
+                    break;
+                std::this_thread::yield();
+                continue;
+            }
+            for (auto& t : slots[slot])
+                checksum += t.run();
+            processed.fetch_add(slots[slot].size(), std::memory_order_relaxed);
+            slots[slot].clear(); // frames die on the worker
+            ready.store(-1, std::memory_order_release);
+        }
+        escape(&checksum);
+    });
+
+    uint64_t seq = 0;
+    int slot = 0;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(DURATION_SECS);
+    while (Clock::now() < deadline)
+    {
+        // creating the task allocates the root frame on the producer
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < HANDOFF_BATCH; ++i)
+            slots[slot].push_back(route<Tframe>(seq++));
+        recorder.record(static_cast<uint64_t>(std::chrono::duration_cast<Duration>(Clock::now() - t0).count()) / HANDOFF_BATCH);
+
+        while (ready.load(std::memory_order_acquire) != -1)
+            std::this_thread::yield();
+        ready.store(slot, std::memory_order_release);
+        slot ^= 1;
+    }
+    while (ready.load(std::memory_order_acquire) != -1)
+        std::this_thread::yield();
+    done.store(true, std::memory_order_release);
+    worker.join();
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    return {name, processed.load(), elapsed, recorder.compute()};
+}
+
+int main()
+{
+    printf("╔══════════════════════════════════════════════════════════════╗\n");
+    printf("║      Coroutine Pipeline — Frame Allocator Benchmark         ║\n");
+    printf("╠══════════════════════════════════════════════════════════════╣\n");
+    printf("║  route → enrich → validate → decode, + decode: 5 frames/msg  ║\n");
+    printf("║  Duration: %d seconds per run                                ║\n", DURATION_SECS);
+    printf("╚══════════════════════════════════════════════════════════════╝\n");
+
+    std::vector<BenchResult> single;
+    single.push_back(run_single<heap_frame>("Default heap"));
+    single.push_back(run_single<frame_promise<>>("AL::frame_promise"));
+    print_results("Single-threaded (latency: one message, ns)", single);
+
+    std::vector<BenchResult> handoff;
+    handoff.push_back(run_handoff<heap_frame>("Default heap"));
+    handoff.push_back(run_handoff<frame_promise<>>("AL::frame_promise"));
+    print_results("Producer → worker (latency: producer ns per started task)", handoff);
+
+    return 0;
+}
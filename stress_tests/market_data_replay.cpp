@@ -275,10 +275,15 @@ int main()
     printf("╚══════════════════════════════════════════════════════════════╝\n");
 
     std::vector<BenchResult> results;
+    size_t arena_huge_bytes = 0;
+    size_t arena_huge_capacity = 0;
 
     // ── Arena (batch mode): alloc all, process all, reset ────────────────
+    // run once on regular pages and once on a 2 MiB aligned transparent huge page region
+    for (mem_flags flags : {mem_flags::none, mem_flags::huge_pages})
     {
-        arena a(ARENA_CAPACITY);
+        const bool huge = flags == mem_flags::huge_pages;
+        arena a(ARENA_CAPACITY, flags);
         FeedStats stats{};
         LatencyRecorder recorder(LATENCY_CAPACITY);
         std::mt19937 rng(42);
@@ -320,7 +325,12 @@ int main()
         }
 
         double total_elapsed = std::chrono::duration<double>(Clock::now() - start).count();
-        results.push_back({"Arena (batch)", batches, messages, total_elapsed, recorder.compute()});
+        results.push_back({huge ? "Arena (huge pages)" : "Arena (batch)", batches, messages, total_elapsed, recorder.compute()});
+        if (huge)
+        {
+            arena_huge_bytes = a.get_huge_page_bytes();
+            arena_huge_capacity = a.get_capacity();
+        }
         escape(&stats);
     }
 
@@ -376,6 +386,113 @@ int main()
         escape(&stats);
     }
 
+    // ── Slab (deferred): frees deferred in the tick, drained after it ─────
+    {
+        default_slab s{};
+        FeedStats stats{};
+        LatencyRecorder recorder(LATENCY_CAPACITY);
+        std::mt19937 rng(42);
+        size_t batches = 0, messages = 0;
+        uint64_t seq = 0;
+
+        auto start = Clock::now();
+        auto deadline = start + std::chrono::seconds(DURATION_SECS);
+
+        while (Clock::now() < deadline)
+        {
+            bool sample = (batches & 15) == 0;
+            auto t0 = sample ? Clock::now() : Clock::time_point{};
+
+            for (size_t i = 0; i < BATCH_SIZE; i++)
+            {
+                size_t sz = pick_msg_size(rng);
+                void* mem = s.alloc(sz);
+                if (mem)
+                {
+                    fill_and_process(mem, sz, seq++, stats);
+                    s.free_deferred(mem, sz);
+                    messages++;
+                }
+            }
+
+            if (sample)
+            {
+                auto elapsed = std::chrono::duration_cast<Duration>(Clock::now() - t0).count();
+                recorder.record(static_cast<uint64_t>(elapsed));
+            }
+            // quiescent point: the tick is done, release its messages
+            s.drain();
+            batches++;
+        }
+
+        double total_elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        results.push_back({"Slab (deferred)", batches, messages, total_elapsed, recorder.compute()});
+        escape(&stats);
+    }
+
+    // ── Slab (bulk mode): one alloc_bulk / free_bulk per message size ────
+    {
+        default_slab s{};
+        FeedStats stats{};
+        LatencyRecorder recorder(LATENCY_CAPACITY);
+        std::mt19937 rng(42);
+        size_t batches = 0, messages = 0;
+        uint64_t seq = 0;
+
+        constexpr size_t sizes[] = {QUOTE_SIZE, TRADE_SIZE, SNAPSHOT_SIZE};
+        std::vector<void*> blocks[3];
+        for (auto& b : blocks)
+            b.resize(BATCH_SIZE);
+        std::vector<size_t> picks(BATCH_SIZE);
+
+        auto start = Clock::now();
+        auto deadline = start + std::chrono::seconds(DURATION_SECS);
+
+        while (Clock::now() < deadline)
+        {
+            bool sample = (batches & 15) == 0;
+            auto t0 = sample ? Clock::now() : Clock::time_point{};
+
+            // the tick's message mix is known up front, so each size is allocated in one call
+            size_t wanted[3] = {};
+            for (size_t i = 0; i < BATCH_SIZE; i++)
+            {
+                size_t sz = pick_msg_size(rng);
+                picks[i] = sz == QUOTE_SIZE ? 0 : sz == TRADE_SIZE ? 1 : 2;
+                wanted[picks[i]]++;
+            }
+
+            size_t got[3];
+            for (size_t k = 0; k < 3; k++)
+                got[k] = s.alloc_bulk(sizes[k], wanted[k], blocks[k].data());
+
+            size_t used[3] = {};
+            for (size_t i = 0; i < BATCH_SIZE; i++)
+            {
+                size_t k = picks[i];
+                if (used[k] < got[k])
+                {
+                    fill_and_process(blocks[k][used[k]++], sizes[k], seq++, stats);
+                    messages++;
+                }
+            }
+
+            for (size_t k = 0; k < 3; k++)
+                s.free_bulk(sizes[k], blocks[k].data(), got[k]);
+
+            if (sample)
+            {
+                auto elapsed = std::chrono::duration_cast<Duration>(Clock::now() - t0).count();
+                recorder.record(static_cast<uint64_t>(elapsed));
+            }
+            batches++;
+        }
+
+        double total_elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        results.push_back({"Slab (bulk)", batches, messages, total_elapsed, recorder.compute()});
+        escape(&stats);
+    }
+
     // ── Dynamic Slab ─────────────────────────────────────────────────────
     {
         default_dynamic_slab ds{};
@@ -532,6 +649,8 @@ int main()
 
     printf("\n━━━ Market Data Feed Processing (batch of %zu, %ds each) ━━━\n", BATCH_SIZE, DURATION_SECS);
     print_results(results);
+    printf("\n  Arena (huge pages): %.1f of %.1f MiB backed by huge pages\n", static_cast<double>(arena_huge_bytes) / (1024.0 * 1024.0),
+           static_cast<double>(arena_huge_capacity) / (1024.0 * 1024.0));
 
     return 0;
 }
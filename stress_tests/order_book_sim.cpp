@@ -582,6 +582,24 @@ void print_results(const char* title, const std::vector<BenchResult>& results)
     }
 }
 
+struct HugePageReport
+{
+    const char* name;
+    size_t huge_bytes;
+    size_t region_bytes;
+};
+
+void print_huge_pages(const std::vector<HugePageReport>& reports)
+{
+    printf("\n  %-22s %12s %12s\n", "Huge page coverage", "huge MiB", "region MiB");
+    printf("  ──────────────────────────────────────────────\n");
+    for (const auto& r : reports)
+    {
+        printf("  %-22s %12.1f %12.1f\n", r.name, static_cast<double>(r.huge_bytes) / (1024.0 * 1024.0),
+               static_cast<double>(r.region_bytes) / (1024.0 * 1024.0));
+    }
+}
+
 // ─── Main ────────────────────────────────────────────────────────────────────
 
 int main()
@@ -599,6 +617,7 @@ int main()
     // ── Single-threaded ──────────────────────────────────────────────────
     {
         std::vector<BenchResult> results;
+        std::vector<HugePageReport> huge_reports;
 
         {
             pool p(order_size, POOL_CAPACITY);
@@ -607,6 +626,14 @@ int main()
                 [&]() -> void* { return p.alloc(); },
                 [&](Order* o) { p.free(o); }));
         }
+        {
+            pool p(order_size, POOL_CAPACITY, mem_flags::huge_pages);
+            results.push_back(run_st(
+                "Pool (huge pages)",
+                [&]() -> void* { return p.alloc(); },
+                [&](Order* o) { p.free(o); }));
+            huge_reports.push_back({"Pool (huge pages)", p.get_huge_page_bytes(), p.get_capacity()});
+        }
         {
             slab<order_slab_cfg> s{};
             results.push_back(run_st(
@@ -614,6 +641,21 @@ int main()
                 [&]() -> void* { return s.alloc(order_size); },
                 [&](Order* o) { s.free(o, order_size); }));
         }
+        {
+            slab<order_slab_cfg> s{};
+            results.push_back(run_st(
+                "Slab (alloc<N>)",
+                [&]() -> void* { return s.alloc<order_size>(); },
+                [&](Order* o) { s.free<order_size>(o); }));
+        }
+        {
+            slab<order_slab_cfg> s(mem_flags::huge_pages);
+            results.push_back(run_st(
+                "Slab (huge pages)",
+                [&]() -> void* { return s.alloc(order_size); },
+                [&](Order* o) { s.free(o, order_size); }));
+            huge_reports.push_back({"Slab (huge pages)", s.get_huge_page_bytes(), static_cast<size_t>(s.region_end() - s.region_start())});
+        }
         {
             default_dynamic_slab ds{};
             results.push_back(run_st(
@@ -635,6 +677,7 @@ int main()
         }
 
         print_results("Single-Threaded Order Book", results);
+        print_huge_pages(huge_reports);
     }
 
     // ── Multi-threaded ───────────────────────────────────────────────────
@@ -662,6 +705,13 @@ int main()
                 [&]() -> void* { return s.alloc(order_size); },
                 [&](Order* o) { s.free(o, order_size); }));
         }
+        {
+            slab<order_slab_cfg> s{};
+            results.push_back(run_mt(
+                "Slab (alloc<N>)", num_threads,
+                [&]() -> void* { return s.alloc<order_size>(); },
+                [&](Order* o) { s.free<order_size>(o); }));
+        }
         {
             default_dynamic_slab ds{};
             results.push_back(run_mt(
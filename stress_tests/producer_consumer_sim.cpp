@@ -10,12 +10,20 @@
 // The consumer dequeues, verifies content, and frees. A lock-free ring buffer
 // connects the two threads.
 //
-// Allocators tested: Pool, Slab, Dynamic Slab, jemalloc, malloc
-// Mode: Multi-threaded (1 producer + 1 consumer)
+// A second phase sends variable-size records (16–512B), where the double-mapped
+// ring buffer allocates by bumping a head and the consumer frees in FIFO order.
+//
+// A third phase fans every message out to three consumers (strategy, recorder,
+// risk), either as one reference-counted shared_block or as a copy per consumer.
+//
+// Allocators tested: Pool, Slab, Dynamic Slab, Ring buffer, jemalloc, malloc
+// Mode: Multi-threaded (1 producer + 1 consumer, then 1 producer + 3 consumers)
 // ═══════════════════════════════════════════════════════════════════════════════
 
 #include "dynamic_slab.h"
 #include "pool.h"
+#include "ring_buffer.h"
+#include "shared_block.h"
 #include "slab.h"
 
 #include <jemalloc/jemalloc.h>
@@ -259,6 +267,274 @@ BenchResult run_producer_consumer(const char* name, AllocFn alloc_fn, FreeFn fre
     return {name, total, elapsed, produce_recorder.compute(), e2e_recorder.compute()};
 }
 
+// ─── Variable-size records ───────────────────────────────────────────────────
+
+static constexpr size_t MIN_RECORD = 16;
+static constexpr size_t MAX_RECORD = 512;
+static constexpr size_t RING_CAPACITY = 4 << 20;
+
+struct RecordHeader
+{
+    uint64_t sequence;
+    uint64_t produce_ts;
+};
+
+// deterministic size sequence so every allocator sees the same mix
+inline size_t record_length(uint64_t seq)
+{
+    uint64_t x = seq * 0x9E3779B97F4A7C15ull;
+    return MIN_RECORD + static_cast<size_t>((x >> 40) % (MAX_RECORD - MIN_RECORD + 1));
+}
+
+template <typename AllocFn, typename FreeFn>
+BenchResult run_variable_records(const char* name, AllocFn alloc_fn, FreeFn free_fn)
+{
+    SPSCQueue queue;
+    std::atomic<bool> producer_done{false};
+    std::atomic<size_t> consumed{0};
+
+    LatencyRecorder produce_recorder(LATENCY_CAPACITY);
+    LatencyRecorder e2e_recorder(LATENCY_CAPACITY);
+
+    std::thread producer([&] {
+        uint64_t seq = 0;
+        auto deadline = Clock::now() + std::chrono::seconds(DURATION_SECS);
+
+        while (Clock::now() < deadline)
+        {
+            bool sample = (seq & 127) == 0;
+            auto t0 = sample ? Clock::now() : Clock::time_point{};
+
+            size_t len = record_length(seq);
+            void* mem = alloc_fn(len);
+            if (!mem)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            auto* rec = static_cast<RecordHeader*>(mem);
+            rec->sequence = seq;
+            rec->produce_ts = static_cast<uint64_t>(
+                std::chrono::duration_cast<Duration>(Clock::now().time_since_epoch()).count());
+            std::memset(rec + 1, static_cast<int>(seq & 0xFF), len - sizeof(RecordHeader));
+            escape(rec);
+
+            while (!queue.try_push(rec))
+                std::this_thread::yield();
+
+            if (sample)
+            {
+                auto elapsed = std::chrono::duration_cast<Duration>(Clock::now() - t0).count();
+                produce_recorder.record(static_cast<uint64_t>(elapsed));
+            }
+            seq++;
+        }
+
+        producer_done.store(true, std::memory_order_release);
+    });
+
+    std::thread consumer([&] {
+        auto consume = [&](void* ptr) {
+            auto* rec = static_cast<RecordHeader*>(ptr);
+            size_t len = record_length(rec->sequence);
+            auto* body = reinterpret_cast<const unsigned char*>(rec + 1);
+            uint64_t check = body[0] ^ body[len - sizeof(RecordHeader) - 1];
+            escape(&check);
+
+            if ((rec->sequence & 127) == 0)
+            {
+                auto now_ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<Duration>(Clock::now().time_since_epoch()).count());
+                e2e_recorder.record(now_ns - rec->produce_ts);
+            }
+
+            free_fn(rec, len);
+            consumed.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        while (true)
+        {
+            void* ptr = nullptr;
+            if (queue.try_pop(ptr))
+            {
+                consume(ptr);
+            }
+            else if (producer_done.load(std::memory_order_acquire))
+            {
+                while (queue.try_pop(ptr))
+                    consume(ptr);
+                break;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    return {name, consumed.load(), static_cast<double>(DURATION_SECS), produce_recorder.compute(), e2e_recorder.compute()};
+}
+
+// ─── Fan-out: one message, several consumers ─────────────────────────────────
+
+static constexpr size_t FANOUT = 3;
+
+// publish(seq, out) fills out[i] with what consumer i gets: the same shared block for every consumer, or a copy each.
+// consume(ptr) is called once per pointer and drops that consumer's reference / copy
+template <typename PublishFn, typename ConsumeFn>
+BenchResult run_fanout(const char* name, PublishFn publish, ConsumeFn consume)
+{
+    std::vector<SPSCQueue> queues(FANOUT);
+    std::atomic<bool> producer_done{false};
+    std::atomic<size_t> consumed{0};
+
+    LatencyRecorder produce_recorder(LATENCY_CAPACITY);
+    LatencyRecorder e2e_recorder(LATENCY_CAPACITY);
+
+    std::thread producer([&] {
+        uint64_t seq = 0;
+        auto deadline = Clock::now() + std::chrono::seconds(DURATION_SECS);
+        std::array<Message*, FANOUT> out{};
+
+        while (Clock::now() < deadline)
+        {
+            bool sample = (seq & 127) == 0;
+            auto t0 = sample ? Clock::now() : Clock::time_point{};
+
+            if (!publish(seq, out))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t c = 0; c < FANOUT; ++c)
+            {
+                while (!queues[c].try_push(out[c]))
+                    std::this_thread::yield();
+            }
+
+            if (sample)
+            {
+                auto elapsed = std::chrono::duration_cast<Duration>(Clock::now() - t0).count();
+                produce_recorder.record(static_cast<uint64_t>(elapsed));
+            }
+            seq++;
+        }
+
+        producer_done.store(true, std::memory_order_release);
+    });
+
+    // only the first consumer records end-to-end latency, the recorder is not shared
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < FANOUT; ++c)
+    {
+        consumers.emplace_back([&, c] {
+            auto handle = [&](void* ptr) {
+                auto* msg = static_cast<Message*>(ptr);
+                uint64_t check = 0;
+                for (int i = 0; i < 5; i++)
+                    check ^= msg->payload[i];
+                escape(&check);
+
+                if (c == 0 && (msg->sequence & 127) == 0)
+                {
+                    auto now_ns = static_cast<uint64_t>(
+                        std::chrono::duration_cast<Duration>(Clock::now().time_since_epoch()).count());
+                    e2e_recorder.record(now_ns - msg->produce_ts);
+                }
+
+                consume(msg);
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            };
+
+            while (true)
+            {
+                void* ptr = nullptr;
+                if (queues[c].try_pop(ptr))
+                {
+                    handle(ptr);
+                }
+                else if (producer_done.load(std::memory_order_acquire))
+                {
+                    while (queues[c].try_pop(ptr))
+                        handle(ptr);
+                    break;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    producer.join();
+    for (auto& t : consumers)
+        t.join();
+
+    // messages published, each seen by every consumer
+    return {name, consumed.load() / FANOUT, static_cast<double>(DURATION_SECS), produce_recorder.compute(), e2e_recorder.compute()};
+}
+
+inline void fill_message(Message* msg, uint64_t seq)
+{
+    msg->sequence = seq;
+    msg->produce_ts = static_cast<uint64_t>(
+        std::chrono::duration_cast<Duration>(Clock::now().time_since_epoch()).count());
+    for (int i = 0; i < 5; i++)
+        msg->payload[i] = seq * 7 + i;
+    msg->checksum = 0;
+    for (int i = 0; i < 5; i++)
+        msg->checksum ^= msg->payload[i];
+    escape(msg);
+}
+
+// zero-copy: one block, one reference per consumer
+template <typename Towner>
+auto shared_publish(Towner& owner)
+{
+    return [&owner](uint64_t seq, std::array<Message*, FANOUT>& out) {
+        auto* block = shared_block<Towner>::make(owner, MSG_SIZE, FANOUT);
+        if (block == nullptr)
+            return false;
+        auto* msg = static_cast<Message*>(block->data());
+        fill_message(msg, seq);
+        out.fill(msg);
+        return true;
+    };
+}
+
+template <typename Towner>
+auto shared_consume()
+{
+    return [](Message* msg) { shared_block<Towner>::from_data(msg)->release(); };
+}
+
+// the usual alternative: every consumer gets its own copy and frees it
+template <typename AllocFn, typename FreeFn>
+auto copy_publish(AllocFn alloc_fn, FreeFn free_fn)
+{
+    return [alloc_fn, free_fn](uint64_t seq, std::array<Message*, FANOUT>& out) {
+        for (size_t c = 0; c < FANOUT; ++c)
+        {
+            out[c] = static_cast<Message*>(alloc_fn());
+            if (out[c] == nullptr)
+            {
+                while (c-- > 0)
+                    free_fn(out[c]);
+                return false;
+            }
+        }
+        fill_message(out[0], seq);
+        for (size_t c = 1; c < FANOUT; ++c)
+            std::memcpy(out[c], out[0], MSG_SIZE);
+        return true;
+    };
+}
+
 // ─── Custom slab config for 64B messages ─────────────────────────────────────
 
 constexpr std::array<size_class, 1> msg_slab_classes = {
@@ -358,5 +634,83 @@ int main()
     printf("\n━━━ Producer-Consumer Pipeline (SPSC, %ds each) ━━━\n", DURATION_SECS);
     print_results(results);
 
+    std::vector<BenchResult> var_results;
+
+    // Ring buffer: zero-copy, records stay contiguous across the wrap
+    {
+        ring_buffer ring(RING_CAPACITY);
+        var_results.push_back(run_variable_records(
+            "Ring buffer",
+            [&](size_t len) -> void* { return ring.alloc(len); },
+            [&](RecordHeader* r, size_t) { ring.free(r); }));
+    }
+
+    // Dynamic Slab
+    {
+        default_dynamic_slab ds{};
+        var_results.push_back(run_variable_records(
+            "Dynamic Slab",
+            [&](size_t len) -> void* { return ds.palloc(len); },
+            [&](RecordHeader* r, size_t len) { ds.free(r, len); }));
+    }
+
+    // jemalloc
+    {
+        var_results.push_back(run_variable_records(
+            "jemalloc",
+            [](size_t len) -> void* { return mallocx(len, 0); },
+            [](RecordHeader* r, size_t) { dallocx(r, 0); }));
+    }
+
+    // glibc malloc
+    {
+        var_results.push_back(run_variable_records(
+            "malloc",
+            [](size_t len) -> void* { return std::malloc(len); },
+            [](RecordHeader* r, size_t) { std::free(r); }));
+    }
+
+    printf("\n━━━ Variable-size records (%zu–%zuB, SPSC, %ds each) ━━━\n", MIN_RECORD, MAX_RECORD, DURATION_SECS);
+    print_results(var_results);
+
+    std::vector<BenchResult> fanout_results;
+
+    // Pool + shared_block: the header needs a 16B larger block
+    {
+        pool p(MSG_SIZE + 16, POOL_CAPACITY);
+        fanout_results.push_back(run_fanout("Pool (shared)", shared_publish(p), shared_consume<pool>()));
+    }
+
+    // Dynamic Slab + shared_block
+    {
+        default_dynamic_slab ds{};
+        fanout_results.push_back(run_fanout("Dynamic Slab (shared)", shared_publish(ds), shared_consume<default_dynamic_slab>()));
+    }
+
+    // Dynamic Slab, a copy per consumer
+    {
+        default_dynamic_slab ds{};
+        auto alloc_fn = [&]() -> void* { return ds.palloc(MSG_SIZE); };
+        auto free_fn = [&](Message* m) { ds.free(m, MSG_SIZE); };
+        fanout_results.push_back(run_fanout("Dynamic Slab (copy)", copy_publish(alloc_fn, free_fn), free_fn));
+    }
+
+    // jemalloc, a copy per consumer
+    {
+        auto alloc_fn = []() -> void* { return mallocx(MSG_SIZE, 0); };
+        auto free_fn = [](Message* m) { dallocx(m, 0); };
+        fanout_results.push_back(run_fanout("jemalloc (copy)", copy_publish(alloc_fn, free_fn), free_fn));
+    }
+
+    // glibc malloc, a copy per consumer
+    {
+        auto alloc_fn = []() -> void* { return std::malloc(MSG_SIZE); };
+        auto free_fn = [](Message* m) { std::free(m); };
+        fanout_results.push_back(run_fanout("malloc (copy)", copy_publish(alloc_fn, free_fn), free_fn));
+    }
+
+    printf("\n━━━ Fan-out (1 producer → %zu consumers, %ds each) ━━━\n", FANOUT, DURATION_SECS);
+    print_results(fanout_results);
+
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <cstddef>
 #include <cstring>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <vector>
 
@@ -326,3 +327,175 @@ TEST_CASE("Arena: Capacity rounding", "[arena][capacity]")
     }
 }
 
+
+static size_t resident_pages(void* ptr, size_t bytes)
+{
+    size_t pages = (bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    std::vector<unsigned char> vec(pages);
+    REQUIRE(mincore(ptr, bytes, vec.data()) == 0);
+    size_t resident = 0;
+    for (unsigned char v : vec)
+        resident += v & 1;
+    return resident;
+}
+
+TEST_CASE("Arena: Prefault and lock flags", "[arena][flags]")
+{
+    SECTION("No flags leaves pages unbacked")
+    {
+        AL::arena a(PAGE_SIZE * 16);
+        void* ptr = a.alloc(PAGE_SIZE * 16);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(resident_pages(ptr, PAGE_SIZE * 16) == 0);
+    }
+
+    SECTION("Populate backs every page at construction")
+    {
+        AL::arena a(PAGE_SIZE * 16, AL::mem_flags::populate);
+        void* ptr = a.alloc(PAGE_SIZE * 16);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(resident_pages(ptr, PAGE_SIZE * 16) == 16);
+    }
+
+    SECTION("Prefault touches every page and keeps it zeroed")
+    {
+        AL::arena a(PAGE_SIZE * 16, AL::mem_flags::prefault);
+        auto* ptr = static_cast<unsigned char*>(a.alloc(PAGE_SIZE * 16));
+        REQUIRE(ptr != nullptr);
+        REQUIRE(resident_pages(ptr, PAGE_SIZE * 16) == 16);
+        for (size_t i = 0; i < PAGE_SIZE * 16; i += PAGE_SIZE)
+            REQUIRE(ptr[i] == 0);
+    }
+
+    SECTION("Lock pins the region")
+    {
+        AL::arena a(PAGE_SIZE * 4, AL::mem_flags::lock | AL::mem_flags::populate);
+        void* ptr = a.alloc(PAGE_SIZE * 4);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(resident_pages(ptr, PAGE_SIZE * 4) == 4);
+    }
+}
+
+TEST_CASE("Arena: Huge page flags", "[arena][flags][huge]")
+{
+    constexpr size_t HUGE = AL::platform_mem::huge_page_size;
+
+    SECTION("Transparent huge pages round capacity and align the region")
+    {
+        AL::arena a(HUGE + 1, AL::mem_flags::huge_pages | AL::mem_flags::prefault);
+        REQUIRE(a.get_capacity() == HUGE * 2);
+        void* ptr = a.alloc(HUGE * 2);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr) % HUGE == 0);
+        REQUIRE(resident_pages(ptr, HUGE * 2) == HUGE * 2 / PAGE_SIZE);
+        // the kernel may decline to back the range with huge pages, never more than the region though
+        REQUIRE(a.get_huge_page_bytes() <= a.get_capacity());
+    }
+
+    SECTION("Hugetlb falls back to transparent huge pages when the pool is empty")
+    {
+        AL::arena a(HUGE, AL::mem_flags::huge_tlb);
+        REQUIRE(a.get_capacity() == HUGE);
+        void* ptr = a.alloc(HUGE);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr) % HUGE == 0);
+        std::memset(ptr, 0xAB, HUGE);
+        REQUIRE(a.get_huge_page_bytes() <= a.get_capacity());
+    }
+}
+
+TEST_CASE("Arena: try_extend grows the last allocation in place", "[arena][extend]")
+{
+    AL::arena a(PAGE_SIZE);
+
+    SECTION("Last allocation grows, used follows")
+    {
+        void* p = a.alloc(100);
+        REQUIRE(p != nullptr);
+        REQUIRE(a.try_extend(p, 100, 1000));
+        REQUIRE(a.get_used() == 1008);
+        std::memset(p, 0xCD, 1000);
+
+        // the next allocation starts after the extended block
+        auto* q = static_cast<std::byte*>(a.alloc(16));
+        REQUIRE(q == static_cast<std::byte*>(p) + 1008);
+    }
+
+    SECTION("Padding already covers the new length")
+    {
+        void* p = a.alloc(17);
+        REQUIRE(a.try_extend(p, 17, 32));
+        REQUIRE(a.get_used() == 32);
+    }
+
+    SECTION("Only the most recent allocation can grow")
+    {
+        void* p1 = a.alloc(64);
+        void* p2 = a.alloc(64);
+        REQUIRE_FALSE(a.try_extend(p1, 64, 128));
+        REQUIRE(a.get_used() == 128);
+        REQUIRE(a.try_extend(p2, 64, 128));
+        REQUIRE(a.get_used() == 192);
+    }
+
+    SECTION("Capacity and foreign pointers are respected")
+    {
+        void* p = a.alloc(64);
+        REQUIRE_FALSE(a.try_extend(p, 64, a.get_capacity() + 1));
+        REQUIRE(a.try_extend(p, 64, a.get_capacity()));
+        REQUIRE(a.get_used() == a.get_capacity());
+
+        int local = 0;
+        REQUIRE_FALSE(a.try_extend(&local, sizeof(local), 64));
+        REQUIRE_FALSE(a.try_extend(nullptr, 0, 64));
+    }
+}
+
+TEST_CASE("Arena: arena_buffer appends without copying while on top", "[arena][extend][buffer]")
+{
+    AL::arena a(PAGE_SIZE * 4);
+
+    SECTION("Growing on top keeps the address and wastes nothing")
+    {
+        AL::arena_buffer<char> text(a);
+        for (int i = 0; i < 1000; ++i)
+            REQUIRE(text.push_back(static_cast<char>('a' + i % 26)));
+        const char* first = text.data();
+        REQUIRE(text.append("0123456789", 10));
+        REQUIRE(text.data() == first);
+        REQUIRE(text.size() == 1010);
+        REQUIRE(text[0] == 'a');
+        REQUIRE(text[1009] == '9');
+        // only the buffer's final capacity is in use
+        REQUIRE(a.get_used() <= ((text.capacity() + 15) & ~size_t(15)));
+    }
+
+    SECTION("An allocation in between forces one copy, contents survive")
+    {
+        AL::arena_buffer<int> values(a);
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(values.push_back(i));
+        const int* before = values.data();
+
+        void* other = a.alloc(8);
+        REQUIRE(other != nullptr);
+        for (int i = 10; i < 100; ++i)
+            REQUIRE(values.push_back(i));
+
+        REQUIRE(values.data() != before);
+        REQUIRE(values.size() == 100);
+        for (int i = 0; i < 100; ++i)
+            REQUIRE(values[i] == i);
+    }
+
+    SECTION("A full arena leaves the buffer unchanged")
+    {
+        AL::arena_buffer<std::byte> bytes(a);
+        std::vector<std::byte> chunk(a.get_capacity() - 64, std::byte{1});
+        REQUIRE(bytes.append(chunk.data(), chunk.size()));
+        REQUIRE_FALSE(bytes.append(chunk.data(), 128));
+        REQUIRE(bytes.size() == chunk.size());
+        REQUIRE(bytes.append(chunk.data(), 64));
+        REQUIRE(bytes.size() == a.get_capacity());
+    }
+}
@@ -0,0 +1,210 @@
+#include "coroutine_frame.h"
+#include <catch2/catch_test_macros.hpp>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace AL;
+
+namespace
+{
+
+// lazily started task whose frames come from the frame allocator
+template<typename T>
+class task
+{
+public:
+    struct promise_type : frame_promise<>
+    {
+        T value{};
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        task get_return_object()
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        auto final_suspend() noexcept
+        {
+            struct resume_continuation
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+                {
+                    return h.promise().continuation;
+                }
+                void await_resume() noexcept
+                {}
+            };
+            return resume_continuation{};
+        }
+        void return_value(T v)
+        {
+            value = v;
+        }
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    explicit task(std::coroutine_handle<promise_type> h) : m_handle(h)
+    {}
+    task(task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr))
+    {}
+    task(const task&) = delete;
+    ~task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        m_handle.promise().continuation = caller;
+        return m_handle;
+    }
+    T await_resume()
+    {
+        return m_handle.promise().value;
+    }
+
+    // runs to completion on the calling thread
+    T get()
+    {
+        m_handle.resume();
+        return m_handle.promise().value;
+    }
+
+    void* frame() const
+    {
+        return m_handle.address();
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+task<int> leaf(int x)
+{
+    co_return x * 2;
+}
+
+task<int> middle(int x)
+{
+    int a = co_await leaf(x);
+    int b = co_await leaf(x + 1);
+    co_return a + b;
+}
+
+task<int> root(int n)
+{
+    int sum = 0;
+    for (int i = 0; i < n; ++i)
+        sum += co_await middle(i);
+    co_return sum;
+}
+
+} // namespace
+
+TEST_CASE("Coroutine frame: Recycler reuses the last freed frame of a size", "[coroutine][frame]")
+{
+    void* a = default_frame_allocator::alloc(200);
+    REQUIRE(a != nullptr);
+    default_frame_allocator::free(a, 200);
+
+    // LIFO: the same frame comes straight back
+    void* b = default_frame_allocator::alloc(200);
+    REQUIRE(b == a);
+
+    // a different size never gets it
+    void* c = default_frame_allocator::alloc(208);
+    REQUIRE(c != nullptr);
+    REQUIRE(c != a);
+
+    default_frame_allocator::free(b, 200);
+    default_frame_allocator::free(c, 208);
+}
+
+TEST_CASE("Coroutine frame: Oversized frames use the global heap", "[coroutine][frame]")
+{
+    const size_t size = default_frame_allocator::MAX_FRAME_SIZE + 1;
+    void* p = default_frame_allocator::alloc(size);
+    REQUIRE(p != nullptr);
+    default_frame_allocator::free(p, size);
+}
+
+TEST_CASE("Coroutine frame: Nested tasks allocate and free their frames", "[coroutine][frame]")
+{
+    // sum over i of 2i + 2(i + 1)
+    auto expected = [](int n) { return 2 * n * n; };
+
+    for (int round = 0; round < 100; ++round)
+        REQUIRE(root(50).get() == expected(50));
+
+    // steady state: frames come back to the same addresses
+    void* first = nullptr;
+    {
+        task<int> t = leaf(1);
+        first = t.frame();
+        REQUIRE(t.get() == 2);
+    }
+    task<int> t = leaf(2);
+    REQUIRE(t.frame() == first);
+    REQUIRE(t.get() == 4);
+}
+
+TEST_CASE("Coroutine frame: Frames can be freed on another thread", "[coroutine][frame][threads]")
+{
+    std::vector<task<int>> tasks;
+    for (int i = 0; i < 200; ++i)
+        tasks.push_back(middle(i));
+
+    int sum = 0;
+    std::thread worker([&] {
+        for (auto& t : tasks)
+            sum += t.get();
+        // every frame is destroyed here, on the worker
+        tasks.clear();
+    });
+    worker.join();
+
+    int expected = 0;
+    for (int i = 0; i < 200; ++i)
+        expected += 4 * i + 2;
+    REQUIRE(sum == expected);
+}
+
+TEST_CASE("Coroutine frame: An exiting thread returns its recycled frames", "[coroutine][frame][threads]")
+{
+    // a type of its own, so its backing slab sees only this thread
+    using frames = frame_allocator<slab_config<>, 2, 8>;
+    auto& slab = frames::backing();
+
+    std::thread worker([] {
+        std::vector<void*> live;
+        for (size_t size : {96, 200, 400})
+        {
+            for (int i = 0; i < 20; ++i)
+                live.push_back(frames::alloc(size));
+        }
+        for (size_t i = 0; i < live.size(); ++i)
+            frames::free(live[i], i < 20 ? 96 : i < 40 ? 200 : 400);
+    });
+    worker.join();
+
+    REQUIRE(slab.get_total_free() == slab.get_total_capacity());
+}
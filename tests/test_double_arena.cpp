@@ -0,0 +1,114 @@
+#include "double_arena.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <utility>
+
+static const size_t PAGE_SIZE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+TEST_CASE("Double arena: Front grows up, back grows down", "[double_arena][basic]")
+{
+    AL::double_arena a(PAGE_SIZE);
+    REQUIRE(a.get_capacity() == PAGE_SIZE);
+    REQUIRE(a.get_free() == PAGE_SIZE);
+
+    auto* f1 = static_cast<std::byte*>(a.alloc_front(10));
+    auto* f2 = static_cast<std::byte*>(a.alloc_front(16));
+    auto* b1 = static_cast<std::byte*>(a.alloc_back(10));
+    auto* b2 = static_cast<std::byte*>(a.alloc_back(16));
+    REQUIRE(f1 != nullptr);
+    REQUIRE(f2 == f1 + 16);
+    REQUIRE(b1 == f1 + PAGE_SIZE - 16);
+    REQUIRE(b2 == b1 - 16);
+    REQUIRE(reinterpret_cast<uintptr_t>(b2) % 16 == 0);
+
+    REQUIRE(a.get_front_used() == 32);
+    REQUIRE(a.get_back_used() == 32);
+    REQUIRE(a.get_free() == PAGE_SIZE - 64);
+
+    REQUIRE(a.alloc_front(0) == nullptr);
+    REQUIRE(a.alloc_back(0) == nullptr);
+
+    auto* z = static_cast<unsigned char*>(a.calloc_back(100));
+    REQUIRE(z != nullptr);
+    for (size_t i = 0; i < 100; ++i)
+        REQUIRE(z[i] == 0);
+}
+
+TEST_CASE("Double arena: Runs out only when the ends meet", "[double_arena][capacity]")
+{
+    AL::double_arena a(PAGE_SIZE);
+
+    void* front = a.alloc_front(PAGE_SIZE / 2);
+    void* back = a.alloc_back(PAGE_SIZE / 2 - 64);
+    REQUIRE(front != nullptr);
+    REQUIRE(back != nullptr);
+    REQUIRE(a.get_free() == 64);
+
+    REQUIRE(a.alloc_front(65) == nullptr);
+    REQUIRE(a.alloc_back(65) == nullptr);
+    REQUIRE(a.alloc_back(32) != nullptr);
+    REQUIRE(a.alloc_front(32) != nullptr);
+    REQUIRE(a.get_free() == 0);
+    REQUIRE(a.alloc_front(1) == nullptr);
+    REQUIRE(a.alloc_back(1) == nullptr);
+
+    // the whole region is usable, both regions are intact
+    std::memset(front, 0x11, PAGE_SIZE / 2);
+    std::memset(back, 0x22, PAGE_SIZE / 2 - 64);
+    REQUIRE(static_cast<unsigned char*>(front)[PAGE_SIZE / 2 - 1] == 0x11);
+}
+
+TEST_CASE("Double arena: Savepoints and resets are per end", "[double_arena][reset]")
+{
+    AL::double_arena a(PAGE_SIZE * 2);
+
+    auto* kept = static_cast<int*>(a.alloc_front(sizeof(int) * 4));
+    kept[0] = 42;
+    const size_t front_mark = a.front_mark();
+    const size_t back_mark = a.back_mark();
+    REQUIRE(back_mark == 0);
+
+    // one phase: scratch at the back, results at the front
+    void* scratch = a.alloc_back(1000);
+    void* result = a.alloc_front(200);
+    REQUIRE(scratch != nullptr);
+    REQUIRE(result != nullptr);
+
+    a.rewind_back(back_mark);
+    REQUIRE(a.get_back_used() == 0);
+    REQUIRE(a.get_front_used() == front_mark + 208);
+    // the rewound space is handed out again
+    REQUIRE(a.alloc_back(1000) == scratch);
+
+    a.rewind_front(front_mark);
+    REQUIRE(a.alloc_front(200) == result);
+    REQUIRE(kept[0] == 42);
+
+    // a mark ahead of the current position is ignored
+    a.rewind_back(a.back_mark() + 16);
+    REQUIRE(a.get_back_used() == 1008);
+
+    a.reset_front();
+    REQUIRE(a.get_front_used() == 0);
+    REQUIRE(a.get_back_used() == 1008);
+    a.reset_back();
+    REQUIRE(a.get_free() == a.get_capacity());
+}
+
+TEST_CASE("Double arena: Move keeps both ends", "[double_arena][move]")
+{
+    AL::double_arena a(PAGE_SIZE);
+    void* f = a.alloc_front(64);
+    void* b = a.alloc_back(64);
+
+    AL::double_arena moved(std::move(a));
+    REQUIRE(a.get_capacity() == 0);
+    REQUIRE(a.alloc_front(1) == nullptr);
+    REQUIRE(moved.get_front_used() == 64);
+    REQUIRE(moved.get_back_used() == 64);
+    REQUIRE(moved.alloc_front(16) == static_cast<std::byte*>(f) + 64);
+    REQUIRE(moved.alloc_back(16) == static_cast<std::byte*>(b) - 16);
+}
@@ -2,6 +2,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <cstring>
 #include <set>
+#include <sys/mman.h>
+#include <utility>
 #include <vector>
 
 using namespace AL;
@@ -390,3 +392,433 @@ TEST_CASE("Dynamic slab: purge then shrink is safe", "[dynamic_slab][purge][shri
     size_t reclaimed = ds.shrink();
     REQUIRE(reclaimed == 0);
 }
+
+// remembers every mapping it hands out, so a test can look at the regions made for one slab
+struct recording_source
+{
+    std::vector<std::pair<void*, size_t>> mappings;
+
+    void* alloc(size_t size, mem_flags flags) noexcept
+    {
+        void* ptr = platform_mem::alloc(size, flags);
+        if (ptr != nullptr)
+            mappings.emplace_back(ptr, size);
+        return ptr;
+    }
+    bool free(void* ptr, size_t size) noexcept
+    {
+        return platform_mem::free(ptr, size);
+    }
+    size_t page_size() const noexcept
+    {
+        return platform_mem::page_size();
+    }
+};
+
+TEST_CASE("Dynamic slab: mem flags apply to growth", "[dynamic_slab][flags]")
+{
+    constexpr std::array<AL::size_class, 1> CFG = {{
+        {.byte_size = 4096, .num_blocks = 16, .batch_size = 1},
+    }};
+    recording_source source;
+    dynamic_slab<slab_config<1, CFG>, source_ref<recording_source>> ds(mem_flags::populate | mem_flags::prefault, source_ref(source));
+    REQUIRE(ds.get_slab_count() == 1);
+    const size_t initial_mappings = source.mappings.size();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 17; ++i)
+    {
+        void* p = ds.palloc(4096);
+        REQUIRE(p != nullptr);
+        ptrs.push_back(p);
+    }
+    REQUIRE(ds.get_slab_count() == 2);
+    REQUIRE(source.mappings.size() > initial_mappings);
+
+    // every page of the grown slab is backed, including the 15 blocks nobody has touched yet
+    const size_t page = platform_mem::page_size();
+    for (size_t i = initial_mappings; i < source.mappings.size(); ++i)
+    {
+        auto [ptr, bytes] = source.mappings[i];
+        std::vector<unsigned char> vec((bytes + page - 1) / page);
+        REQUIRE(mincore(ptr, bytes, vec.data()) == 0);
+        for (unsigned char v : vec)
+            REQUIRE((v & 1) == 1);
+    }
+
+    for (void* p : ptrs)
+        ds.free(p, 4096);
+}
+
+TEST_CASE("Dynamic slab: nested in a buffer or parent arena", "[dynamic_slab][nested]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 64, .batch_size = 8}}
+    };
+    using cfg = slab_config<1, TINY>;
+
+    SECTION("Caller buffer bounds growth")
+    {
+        std::vector<std::byte> buffer(64 * 1024);
+        dynamic_slab<cfg, region_source> ds(buffer.data(), buffer.size());
+        REQUIRE(ds.get_slab_count() == 1);
+
+        std::vector<void*> ptrs;
+        while (void* p = ds.palloc(64))
+        {
+            REQUIRE(static_cast<std::byte*>(p) >= buffer.data());
+            REQUIRE(static_cast<std::byte*>(p) < buffer.data() + buffer.size());
+            ptrs.push_back(p);
+        }
+        REQUIRE(ds.get_slab_count() > 1);
+        REQUIRE(ptrs.size() == ds.get_slab_count() * 64);
+
+        for (void* p : ptrs)
+            ds.free(p, 64);
+    }
+
+    SECTION("Parent arena owns every slab")
+    {
+        arena parent(1 << 20);
+        {
+            dynamic_slab<cfg, arena_source<arena<>>> ds(parent);
+            std::vector<void*> ptrs;
+            for (int i = 0; i < 500; ++i)
+            {
+                void* p = ds.palloc(48);
+                REQUIRE(p != nullptr);
+                ptrs.push_back(p);
+            }
+            REQUIRE(ds.get_slab_count() >= 8);
+            REQUIRE(parent.get_used() > 0);
+            for (void* p : ptrs)
+                ds.free(p, 48);
+        }
+        parent.reset();
+        REQUIRE(parent.get_used() == 0);
+    }
+}
+
+TEST_CASE("Dynamic slab: compile-time size entry points grow like palloc", "[dynamic_slab][static]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 100; ++i)
+    {
+        void* p = ds.palloc<40>();
+        REQUIRE(p != nullptr);
+        ptrs.push_back(p);
+    }
+    REQUIRE(ds.get_slab_count() > 1);
+
+    for (void* p : ptrs)
+        ds.free<40>(p);
+
+    // everything went back, so the same load needs no further growth
+    const size_t slabs = ds.get_slab_count();
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(ds.palloc<40>() != nullptr);
+    REQUIRE(ds.get_slab_count() == slabs);
+}
+
+TEST_CASE("Dynamic slab: bulk alloc grows and bulk free routes by owner", "[dynamic_slab][bulk]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+
+    std::vector<void*> ptrs(100);
+    REQUIRE(ds.alloc_bulk(64, ptrs.size(), ptrs.data()) == ptrs.size());
+    REQUIRE(ds.get_slab_count() == 7);
+
+    std::set<void*> unique(ptrs.begin(), ptrs.end());
+    REQUIRE(unique.size() == ptrs.size());
+    for (void* p : ptrs)
+        std::memset(p, 0xAB, 64);
+
+    // nullptr and pointers from elsewhere are skipped
+    int foreign = 0;
+    ptrs.push_back(nullptr);
+    ptrs.push_back(&foreign);
+    ds.free_bulk(64, ptrs.data(), ptrs.size());
+
+    // every block went back, so refilling needs no growth
+    ptrs.resize(100);
+    REQUIRE(ds.alloc_bulk(64, ptrs.size(), ptrs.data()) == ptrs.size());
+    REQUIRE(ds.get_slab_count() == 7);
+    ds.free_bulk(64, ptrs.data(), ptrs.size());
+
+    REQUIRE(ds.alloc_bulk(0, 1, ptrs.data()) == 0);
+    REQUIRE(ds.alloc_bulk(4096, 1, ptrs.data()) == 0);
+    REQUIRE(ds.get_slab_count() == 7);
+}
+
+TEST_CASE("Dynamic slab: spill uses existing capacity before growing", "[dynamic_slab][spill]")
+{
+    constexpr std::array<AL::size_class, 2> CFG = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}, {.byte_size = 128, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<2, CFG, 2, 1>> ds;
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 32; ++i)
+    {
+        void* p = ds.palloc(64);
+        REQUIRE(p != nullptr);
+        ptrs.push_back(p);
+    }
+    REQUIRE(ds.get_slab_count() == 1);
+
+    // the next one has nowhere left to go
+    void* grown = ds.palloc(64);
+    REQUIRE(grown != nullptr);
+    REQUIRE(ds.get_slab_count() == 2);
+    ptrs.push_back(grown);
+
+    for (void* p : ptrs)
+        ds.free(p, 64);
+
+    // freed spilled blocks are reused before the next growth
+    for (int i = 0; i < 33; ++i)
+        REQUIRE(ds.palloc(64) != nullptr);
+    REQUIRE(ds.get_slab_count() == 2);
+}
+
+TEST_CASE("Dynamic slab: deferred frees drain into every owning slab", "[dynamic_slab][deferred]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY, 0>> ds;
+
+    // more slabs than a thread has cache slots, so the frees below keep evicting cache entries
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 96; ++i)
+        ptrs.push_back(ds.palloc(64));
+    REQUIRE(ds.get_slab_count() == 6);
+    REQUIRE(ds.get_total_free() == 0);
+
+    // interleaved across the slabs
+    for (size_t i = 0; i < 16; ++i)
+    {
+        for (size_t j = i; j < ptrs.size(); j += 16)
+            ds.free_deferred(ptrs[j], 64);
+        REQUIRE(ds.get_total_free() == 0);
+    }
+
+    ds.drain();
+    REQUIRE(ds.get_total_free() == ds.get_total_capacity());
+    REQUIRE(ds.shrink() == 5);
+}
+
+TEST_CASE("Dynamic slab: prewarm grows up front and fills every slab's cache", "[dynamic_slab][prewarm]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+
+    REQUIRE(ds.prewarm({40}) == 40);
+    REQUIRE(ds.get_slab_count() == 3);
+    // the 40 warm blocks sit in this thread's caches
+    REQUIRE(ds.get_total_free() == 8 * 64);
+
+    // served from the caches: no growth, no pool traffic
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 40; ++i)
+    {
+        void* p = ds.palloc(64);
+        REQUIRE(p != nullptr);
+        ptrs.push_back(p);
+    }
+    REQUIRE(ds.get_slab_count() == 3);
+    REQUIRE(ds.get_total_free() == 8 * 64);
+
+    for (void* p : ptrs)
+        ds.free(p, 64);
+    ds.release_warm();
+    REQUIRE(ds.get_total_free() == ds.get_total_capacity());
+    REQUIRE(ds.shrink() == 2);
+}
+
+TEST_CASE("Dynamic slab: lifetime hints keep churn and long-lived objects apart", "[dynamic_slab][lifetime]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+    REQUIRE(ds.get_slab_count(lifetime::short_lived) == 1);
+    REQUIRE(ds.get_slab_count(lifetime::long_lived) == 0);
+
+    // interleave churn with a few objects that stay
+    std::vector<void*> churn;
+    std::vector<void*> kept;
+    for (int i = 0; i < 48; ++i)
+    {
+        void* p = ds.palloc(64);
+        REQUIRE(p != nullptr);
+        churn.push_back(p);
+        if (i % 8 == 0)
+        {
+            void* q = ds.palloc(64, lifetime::long_lived);
+            REQUIRE(q != nullptr);
+            std::memset(q, 0x5A, 64);
+            kept.push_back(q);
+        }
+    }
+    void* forever = ds.calloc(64, lifetime::permanent);
+    REQUIRE(forever != nullptr);
+    REQUIRE(static_cast<unsigned char*>(forever)[63] == 0);
+
+    REQUIRE(ds.get_slab_count(lifetime::short_lived) == 3);
+    // six long-lived objects fill part of a single slab instead of pinning three
+    REQUIRE(ds.get_slab_count(lifetime::long_lived) == 1);
+    REQUIRE(ds.get_slab_count(lifetime::permanent) == 1);
+    REQUIRE(ds.get_slab_count() == 5);
+
+    // free() finds the owner without a hint
+    for (void* p : churn)
+        ds.free(p, 64);
+    ds.release_warm();
+
+    // every short-lived slab but the kept head empties out
+    REQUIRE(ds.shrink() == 2);
+    REQUIRE(ds.get_slab_count(lifetime::short_lived) == 1);
+    REQUIRE(ds.get_slab_count(lifetime::long_lived) == 1);
+    for (void* q : kept)
+        REQUIRE(static_cast<unsigned char*>(q)[0] == 0x5A);
+
+    for (void* q : kept)
+        ds.free(q, 64);
+    ds.free(forever, 64);
+    ds.release_warm();
+    REQUIRE(ds.get_total_free() == ds.get_total_capacity());
+}
+
+TEST_CASE("Dynamic slab: fullest-first placement lets lightly used slabs drain", "[dynamic_slab][placement]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+    REQUIRE(ds.get_placement() == placement::newest_first);
+
+    // three full slabs: ptrs[0, 16) in the oldest, ptrs[32, 48) in the head
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 48; ++i)
+        ptrs.push_back(ds.palloc(64));
+    REQUIRE(ds.get_slab_count() == 3);
+
+    // oldest keeps 8 live, middle 4, head 14
+    std::set<void*> middle_free;
+    for (int i = 0; i < 8; ++i)
+        ds.free(ptrs[i], 64);
+    for (int i = 16; i < 28; ++i)
+    {
+        ds.free(ptrs[i], 64);
+        middle_free.insert(ptrs[i]);
+    }
+    ds.free(ptrs[32], 64);
+    ds.free(ptrs[33], 64);
+    ds.release_warm();
+
+    bool fullest = false;
+    SECTION("Newest first")
+    {}
+    SECTION("Fullest first")
+    {
+        ds.set_placement(placement::fullest_first);
+        fullest = true;
+    }
+
+    // 10 new blocks fit in the head (2) and the oldest slab (8)
+    std::vector<void*> fresh;
+    for (int i = 0; i < 10; ++i)
+    {
+        void* p = ds.palloc(64);
+        REQUIRE(p != nullptr);
+        fresh.push_back(p);
+    }
+    ds.release_warm();
+
+    size_t landed_in_middle = 0;
+    for (void* p : fresh)
+        landed_in_middle += middle_free.count(p);
+
+    for (int i = 28; i < 32; ++i)
+        ds.free(ptrs[i], 64);
+    ds.release_warm();
+
+    if (fullest)
+    {
+        // nothing went to the lightly used middle slab, so it empties out
+        REQUIRE(landed_in_middle == 0);
+        REQUIRE(ds.shrink() == 1);
+        REQUIRE(ds.get_slab_count() == 2);
+    }
+    else
+    {
+        // newest-first refills the middle slab after the head and pins it
+        REQUIRE(landed_in_middle == 8);
+        REQUIRE(ds.shrink() == 0);
+    }
+
+    // a preferred slab was forgotten with the shrink: allocation keeps working
+    void* after = ds.palloc(64);
+    REQUIRE(after != nullptr);
+    ds.free(after, 64);
+}
+
+TEST_CASE("Dynamic slab: fullest-first placement applies to compile-time and bulk allocation", "[dynamic_slab][placement]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+    ds.set_placement(placement::fullest_first);
+
+    // the same three slabs as above: oldest keeps 8 live, middle 4, head 14
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 48; ++i)
+        ptrs.push_back(ds.palloc(64));
+    REQUIRE(ds.get_slab_count() == 3);
+
+    std::set<void*> middle_free;
+    for (int i = 0; i < 8; ++i)
+        ds.free(ptrs[i], 64);
+    for (int i = 16; i < 28; ++i)
+    {
+        ds.free(ptrs[i], 64);
+        middle_free.insert(ptrs[i]);
+    }
+    ds.free(ptrs[32], 64);
+    ds.free(ptrs[33], 64);
+    ds.release_warm();
+
+    std::vector<void*> fresh(10, nullptr);
+    SECTION("palloc<Tsize>")
+    {
+        for (void*& p : fresh)
+            p = ds.palloc<64>();
+    }
+    SECTION("alloc_bulk")
+    {
+        REQUIRE(ds.alloc_bulk(64, fresh.size(), fresh.data()) == fresh.size());
+    }
+    ds.release_warm();
+
+    for (void* p : fresh)
+    {
+        REQUIRE(p != nullptr);
+        REQUIRE(middle_free.count(p) == 0);
+    }
+    for (int i = 28; i < 32; ++i)
+        ds.free(ptrs[i], 64);
+    ds.release_warm();
+    REQUIRE(ds.shrink() == 1);
+}
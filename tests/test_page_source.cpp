@@ -0,0 +1,232 @@
+#include "arena.h"
+#include "dynamic_slab.h"
+#include "page_source.h"
+#include "pool.h"
+#include "slab.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstring>
+#include <sys/mman.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+using namespace AL;
+
+static const size_t PAGE_SIZE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+// counts live regions and bytes so tests can see every region come back
+struct counting_source
+{
+    size_t live_regions = 0;
+    size_t live_bytes = 0;
+
+    void* alloc(size_t size, mem_flags flags) noexcept
+    {
+        void* ptr = platform_mem::alloc(size, flags);
+        if (ptr != nullptr)
+        {
+            ++live_regions;
+            live_bytes += size;
+        }
+        return ptr;
+    }
+    bool free(void* ptr, size_t size) noexcept
+    {
+        --live_regions;
+        live_bytes -= size;
+        return platform_mem::free(ptr, size);
+    }
+    size_t page_size() const noexcept
+    {
+        return platform_mem::page_size();
+    }
+};
+
+static_assert(page_source<counting_source>);
+static_assert(!committable_page_source<counting_source>);
+
+TEST_CASE("Page source: Arena over a user region", "[page_source][region]")
+{
+    std::vector<std::byte> buffer(PAGE_SIZE * 9);
+    arena<PALLOC_DEFAULT_ALIGNMENT, region_source> a(PAGE_SIZE * 4, mem_flags::none, region_source(buffer.data(), buffer.size()));
+
+    auto* ptr = static_cast<std::byte*>(a.alloc(PAGE_SIZE * 4));
+    REQUIRE(ptr != nullptr);
+    REQUIRE(ptr >= buffer.data());
+    REQUIRE(ptr + PAGE_SIZE * 4 <= buffer.data() + buffer.size());
+    std::memset(ptr, 0x5A, PAGE_SIZE * 4);
+
+    REQUIRE(a.get_source().get_used() == PAGE_SIZE * 4);
+    REQUIRE(a.clear() == 0);
+    // the most recent region goes back to the range
+    REQUIRE(a.get_source().get_used() == 0);
+}
+
+TEST_CASE("Page source: Region exhaustion fails construction", "[page_source][region]")
+{
+    std::vector<std::byte> buffer(PAGE_SIZE * 3);
+    using region_arena = arena<PALLOC_DEFAULT_ALIGNMENT, region_source>;
+    REQUIRE_THROWS_AS(region_arena(PAGE_SIZE * 8, mem_flags::none, region_source(buffer.data(), buffer.size())), std::bad_alloc);
+}
+
+TEST_CASE("Page source: Pool releases through its source", "[page_source][pool]")
+{
+    counting_source source;
+    {
+        pool p(source, 64, 1024);
+        REQUIRE(source.live_regions == 1);
+        void* ptr = p.alloc();
+        REQUIRE(ptr != nullptr);
+        p.free(ptr);
+
+        // moving keeps the release path with the region
+        pool moved(std::move(p));
+        REQUIRE(source.live_regions == 1);
+    }
+    REQUIRE(source.live_regions == 0);
+    REQUIRE(source.live_bytes == 0);
+}
+
+TEST_CASE("Page source: Stateless sources by value", "[page_source][pool]")
+{
+    pool p(prefault_source{}, 256, 256, mem_flags::none);
+    void* ptr = p.calloc();
+    REQUIRE(ptr != nullptr);
+    p.free(ptr);
+
+    slab<slab_config<>, huge_page_source> s(mem_flags::none);
+    REQUIRE(reinterpret_cast<uintptr_t>(s.region_start()) % platform_mem::huge_page_size == 0);
+    void* block = s.alloc(64);
+    REQUIRE(block != nullptr);
+    s.free(block, 64);
+}
+
+// records the sizes mapped through it. stateless, so it can stand in as a base_source
+struct recording_platform
+{
+    inline static std::vector<size_t> sizes;
+
+    static void* alloc(size_t size, mem_flags flags) noexcept
+    {
+        sizes.push_back(size);
+        return platform_mem::alloc(size, flags);
+    }
+    static bool free(void* ptr, size_t size) noexcept
+    {
+        return platform_mem::free(ptr, size);
+    }
+    static size_t page_size() noexcept
+    {
+        return platform_mem::page_size();
+    }
+};
+
+// huge_page_source, with the regions and the base source's mappings recorded
+struct recording_huge_source : huge_page_source
+{
+    using base_source = recording_platform;
+    inline static std::vector<size_t> region_sizes;
+
+    static void* alloc(size_t size, mem_flags flags) noexcept
+    {
+        region_sizes.push_back(size);
+        return huge_page_source::alloc(size, flags);
+    }
+};
+
+static_assert(std::is_same_v<huge_page_source::base_source, platform_mem>);
+
+TEST_CASE("Page source: Dynamic slab node headers skip the source's extra flags", "[page_source][dynamic_slab][huge]")
+{
+    constexpr std::array<size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    recording_platform::sizes.clear();
+    recording_huge_source::region_sizes.clear();
+    {
+        dynamic_slab<slab_config<1, TINY>, recording_huge_source> ds;
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 40; ++i)
+            ptrs.push_back(ds.palloc(64));
+        REQUIRE(ds.get_slab_count() == 3);
+
+        // one page-rounded header per slab, mapped without huge pages
+        REQUIRE(recording_platform::sizes.size() == 3);
+        for (size_t size : recording_platform::sizes)
+        {
+            REQUIRE(size < platform_mem::huge_page_size);
+            REQUIRE(size % PAGE_SIZE == 0);
+        }
+        // the slab regions still get them
+        REQUIRE(recording_huge_source::region_sizes.size() == 3);
+        for (size_t size : recording_huge_source::region_sizes)
+            REQUIRE(size % platform_mem::huge_page_size == 0);
+
+        for (void* p : ptrs)
+            ds.free(p, 64);
+    }
+}
+
+TEST_CASE("Page source: Lazy commit is dropped for sources that cannot commit", "[page_source][commit]")
+{
+    counting_source source;
+    pool p(source, 64, 4096, mem_flags::lazy_commit);
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 4096; ++i)
+    {
+        void* ptr = p.alloc();
+        REQUIRE(ptr != nullptr);
+        std::memset(ptr, 1, 64);
+        ptrs.push_back(ptr);
+    }
+    for (void* ptr : ptrs)
+        p.free(ptr);
+}
+
+TEST_CASE("Page source: Dynamic slab draws every slab from one source", "[page_source][dynamic_slab]")
+{
+    constexpr std::array<size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 64, .batch_size = 8}}
+    };
+
+    counting_source source;
+    {
+        dynamic_slab<slab_config<1, TINY>, source_ref<counting_source>> ds(mem_flags::none, source_ref(source));
+        // node header + slab region
+        REQUIRE(source.live_regions == 2);
+
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 200; ++i)
+        {
+            void* ptr = ds.palloc(64);
+            REQUIRE(ptr != nullptr);
+            ptrs.push_back(ptr);
+        }
+        REQUIRE(ds.get_slab_count() > 1);
+        REQUIRE(source.live_regions == ds.get_slab_count() * 2);
+
+        for (void* ptr : ptrs)
+            ds.free(ptr, 64);
+    }
+    REQUIRE(source.live_regions == 0);
+}
+
+TEST_CASE("Page source: memfd backed arena is visible through the fd", "[page_source][memfd]")
+{
+    arena<PALLOC_DEFAULT_ALIGNMENT, memfd_source> a(PAGE_SIZE * 2, mem_flags::none, memfd_source(PAGE_SIZE * 4));
+    auto* ptr = static_cast<char*>(a.alloc(16));
+    REQUIRE(ptr != nullptr);
+    std::strcpy(ptr, "palloc");
+
+    int fd = a.get_source().fd();
+    REQUIRE(fd >= 0);
+    void* view = mmap(nullptr, PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    REQUIRE(view != MAP_FAILED);
+    REQUIRE(std::strcmp(static_cast<const char*>(view), "palloc") == 0);
+    munmap(view, PAGE_SIZE);
+
+    // a second arena does not fit in what is left of the file
+    REQUIRE(a.get_source().get_used() == PAGE_SIZE * 2);
+    REQUIRE(a.get_source().alloc(PAGE_SIZE * 4, mem_flags::none) == nullptr);
+}
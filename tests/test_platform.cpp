@@ -0,0 +1,163 @@
+#include "dynamic_slab.h"
+#include "platform.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace AL;
+
+// ──────────────────────────────────────────────────────────────────────────────
+// no_syscall_scope
+// ──────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("No-syscall scope: mapping is refused and counted", "[platform][no_syscall]")
+{
+    const size_t page = platform_mem::page_size();
+    const size_t total_before = no_syscall_scope::total_refusals();
+
+    REQUIRE_FALSE(no_syscall_scope::active());
+    {
+        no_syscall_scope scope;
+        REQUIRE(no_syscall_scope::active());
+        REQUIRE(scope.refusals() == 0);
+
+        REQUIRE(platform_mem::alloc(page) == nullptr);
+        REQUIRE(platform_mem::alloc(page, mem_flags::lazy_commit) == nullptr);
+        REQUIRE(platform_mem::reserve(page) == nullptr);
+        REQUIRE(scope.refusals() == 3);
+    }
+    REQUIRE_FALSE(no_syscall_scope::active());
+    REQUIRE(no_syscall_scope::total_refusals() >= total_before + 3);
+
+    // outside the scope the same calls work again
+    void* ptr = platform_mem::alloc(page);
+    REQUIRE(ptr != nullptr);
+    REQUIRE(platform_mem::free(ptr, page));
+}
+
+TEST_CASE("No-syscall scope: commit and decommit are refused, frees are deferred", "[platform][no_syscall]")
+{
+    const size_t page = platform_mem::page_size();
+    REQUIRE(platform_mem::release_deferred() == 0);
+
+    void* reserved = platform_mem::reserve(2 * page);
+    REQUIRE(reserved != nullptr);
+    REQUIRE(platform_mem::commit(reserved, page));
+    void* mapped = platform_mem::alloc(page);
+    REQUIRE(mapped != nullptr);
+
+    {
+        no_syscall_scope scope;
+        REQUIRE_FALSE(platform_mem::commit(static_cast<char*>(reserved) + page, page));
+
+        // the pages stay committed and keep their contents
+        static_cast<char*>(reserved)[0] = 7;
+        REQUIRE_FALSE(platform_mem::decommit(reserved, page));
+        REQUIRE(static_cast<char*>(reserved)[0] == 7);
+
+        // reported as done, but nothing reaches the kernel yet
+        REQUIRE(platform_mem::free(mapped, page));
+        static_cast<char*>(mapped)[0] = 1;
+        REQUIRE(platform_mem::deferred_count() == 1);
+        REQUIRE(scope.refusals() == 3);
+
+        // running them from inside a scope would only queue them again
+        REQUIRE(platform_mem::release_deferred() == 0);
+    }
+
+    REQUIRE(platform_mem::release_deferred() == 1);
+    REQUIRE(platform_mem::deferred_count() == 0);
+    REQUIRE(static_cast<char*>(reserved)[0] == 7);
+    REQUIRE(platform_mem::free(reserved, 2 * page));
+}
+
+TEST_CASE("No-syscall scope: frees past the queue capacity are leaked, not run", "[platform][no_syscall]")
+{
+    const size_t page = platform_mem::page_size();
+    REQUIRE(platform_mem::release_deferred() == 0);
+
+    std::vector<void*> pages;
+    for (size_t i = 0; i < platform_mem::deferred_capacity + 1; ++i)
+    {
+        pages.push_back(platform_mem::alloc(page));
+        REQUIRE(pages.back() != nullptr);
+    }
+
+    const size_t leaked_before = platform_mem::leaked_bytes();
+    {
+        no_syscall_scope scope;
+        for (void* p : pages)
+            REQUIRE(platform_mem::free(p, page));
+        REQUIRE(platform_mem::deferred_count() == platform_mem::deferred_capacity);
+        REQUIRE(platform_mem::leaked_bytes() == leaked_before + page);
+        REQUIRE(scope.refusals() == pages.size());
+    }
+
+    // the overflowing page was never unmapped
+    static_cast<char*>(pages.back())[0] = 1;
+    REQUIRE(platform_mem::release_deferred() == platform_mem::deferred_capacity);
+    REQUIRE(platform_mem::free(pages.back(), page));
+}
+
+TEST_CASE("No-syscall scope: scopes nest and are per thread", "[platform][no_syscall]")
+{
+    const size_t page = platform_mem::page_size();
+
+    no_syscall_scope outer;
+    {
+        no_syscall_scope inner;
+        REQUIRE(platform_mem::alloc(page) == nullptr);
+        REQUIRE(inner.refusals() == 1);
+    }
+    REQUIRE(no_syscall_scope::active());
+    REQUIRE(platform_mem::alloc(page) == nullptr);
+    REQUIRE(outer.refusals() == 2);
+
+    // another thread is not inside this scope
+    const size_t thread_before = no_syscall_scope::thread_refusals();
+    std::thread other([page] {
+        void* ptr = platform_mem::alloc(page);
+        REQUIRE(ptr != nullptr);
+        REQUIRE(no_syscall_scope::thread_refusals() == 0);
+        REQUIRE(platform_mem::free(ptr, page));
+    });
+    other.join();
+    REQUIRE(no_syscall_scope::thread_refusals() == thread_before);
+}
+
+TEST_CASE("No-syscall scope: a prewarmed dynamic_slab serves the session without refusals", "[platform][no_syscall]")
+{
+    constexpr std::array<AL::size_class, 1> TINY = {
+        {{.byte_size = 64, .num_blocks = 16, .batch_size = 4}}
+    };
+    dynamic_slab<slab_config<1, TINY>> ds;
+    REQUIRE(ds.prewarm({40}) == 40);
+
+    std::vector<void*> ptrs;
+    {
+        no_syscall_scope session;
+        for (int i = 0; i < 48; ++i)
+        {
+            void* p = ds.palloc(64);
+            REQUIRE(p != nullptr);
+            ptrs.push_back(p);
+        }
+        REQUIRE(session.refusals() == 0);
+
+        // the prewarmed slabs are exhausted: growing would need a mapping
+        REQUIRE(ds.palloc(64) == nullptr);
+        REQUIRE(session.refusals() == 1);
+        REQUIRE(ds.get_slab_count() == 3);
+
+        for (void* p : ptrs)
+            ds.free(p, 64);
+        ds.release_warm();
+
+        // the empty slabs are unlinked now, their pages go back to the OS later
+        REQUIRE(ds.shrink() == 2);
+        REQUIRE(platform_mem::deferred_count() > 0);
+    }
+    REQUIRE(platform_mem::release_deferred() > 0);
+    REQUIRE(platform_mem::deferred_count() == 0);
+}
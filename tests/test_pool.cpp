@@ -2,7 +2,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <set>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <vector>
 
@@ -555,3 +557,101 @@ TEST_CASE("Pool: Alloc exhaustion then reset then reuse", "[pool][reset][edge]")
     REQUIRE(p.alloc() == nullptr);
 }
 
+
+TEST_CASE("Pool: Prefault flags", "[pool][flags]")
+{
+    AL::pool p(64, 1024, AL::mem_flags::populate | AL::mem_flags::prefault);
+    REQUIRE(p.get_free_space() == 64 * 1024);
+
+    std::byte* start = p.get_memory_start();
+    size_t bytes = static_cast<size_t>(p.get_memory_end() - start);
+    auto* page = reinterpret_cast<std::byte*>(reinterpret_cast<uintptr_t>(start) & ~(uintptr_t(PAGE_SIZE) - 1));
+    bytes += static_cast<size_t>(start - page);
+
+    std::vector<unsigned char> vec((bytes + PAGE_SIZE - 1) / PAGE_SIZE);
+    REQUIRE(mincore(page, bytes, vec.data()) == 0);
+    for (unsigned char v : vec)
+        REQUIRE((v & 1) == 1);
+
+    void* ptr = p.alloc();
+    REQUIRE(ptr != nullptr);
+    p.free(ptr);
+}
+
+TEST_CASE("Pool: Lazily committed region", "[pool][commit]")
+{
+    AL::pool p(256, 1 << 16, AL::mem_flags::lazy_commit);
+    REQUIRE(p.get_free_space() == 256 * (1 << 16));
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 1000; ++i)
+    {
+        void* ptr = p.calloc();
+        REQUIRE(ptr != nullptr);
+        ptrs.push_back(ptr);
+    }
+    REQUIRE(p.get_free_space() == 256 * ((1 << 16) - 1000));
+
+    for (void* ptr : ptrs)
+        p.free(ptr);
+    p.reset();
+    REQUIRE(p.alloc() != nullptr);
+}
+
+TEST_CASE("Pool: Huge page backed region", "[pool][flags][huge]")
+{
+    AL::pool p(4096, 512, AL::mem_flags::huge_pages | AL::mem_flags::prefault);
+    REQUIRE(p.get_free_space() == 4096 * 512);
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 512; ++i)
+    {
+        void* ptr = p.alloc();
+        REQUIRE(ptr != nullptr);
+        ptrs.push_back(ptr);
+    }
+    REQUIRE(p.alloc() == nullptr);
+    REQUIRE(p.get_huge_page_bytes() <= 4 * AL::platform_mem::huge_page_size);
+
+    for (void* ptr : ptrs)
+        p.free(ptr);
+    REQUIRE(p.get_free_space() == 4096 * 512);
+}
+
+TEST_CASE("Pool: Calloc skips never-used blocks", "[pool][calloc]")
+{
+    AL::pool p(4096, 8);
+    REQUIRE(p.get_pristine_count() == 8);
+
+    auto* a = static_cast<unsigned char*>(p.calloc());
+    REQUIRE(a != nullptr);
+    REQUIRE(p.get_pristine_count() == 7);
+    for (size_t i = 0; i < 4096; ++i)
+        REQUIRE(a[i] == 0);
+
+    // a recycled block is cleared
+    std::memset(a, 0xAB, 4096);
+    p.free(a);
+    auto* b = static_cast<unsigned char*>(p.calloc());
+    REQUIRE(b == a);
+    REQUIRE(p.get_pristine_count() == 7);
+    for (size_t i = 0; i < 4096; ++i)
+        REQUIRE(b[i] == 0);
+    p.free(b);
+}
+
+TEST_CASE("Pool: Caller regions are never taken as zero", "[pool][calloc]")
+{
+    std::vector<std::byte> buf(AL::pool_view::required_region_size(64, 4) + 64);
+    std::memset(buf.data(), 0xFF, buf.size());
+    void* ptr = buf.data();
+    size_t space = buf.size();
+    void* base = std::align(64, 1, ptr, space);
+
+    AL::pool p;
+    p.init_from_region(base, 64, 4);
+    REQUIRE(p.get_pristine_count() == 0);
+    auto* c = static_cast<unsigned char*>(p.calloc());
+    for (size_t i = 0; i < 64; ++i)
+        REQUIRE(c[i] == 0);
+}
@@ -1,8 +1,10 @@
 #include "pool_view.h"
+#include "platform.h"
 #include <catch2/catch_test_macros.hpp>
 #include <cstddef>
 #include <cstring>
 #include <set>
+#include <sys/mman.h>
 #include <vector>
 
 // helper: allocate a properly-aligned buffer and init a pool_view
@@ -286,3 +288,190 @@ TEST_CASE("pool_view: free nullptr is safe", "[pool_view]")
     view.free(nullptr); // must not crash
     REQUIRE(view.free_count() == 10);
 }
+
+TEST_CASE("pool_view: reserved region commits as the frontier advances", "[pool_view][commit]")
+{
+    const size_t page_size = AL::platform_mem::page_size();
+    constexpr size_t block_size = 64;
+    constexpr size_t block_count = 64 * 1024; // 4 MiB of payload
+    size_t bytes = AL::pool_view::required_region_size(block_size, block_count);
+    bytes = (bytes + page_size - 1) / page_size * page_size;
+
+    void* base = AL::platform_mem::reserve(bytes);
+    REQUIRE(base != nullptr);
+
+    AL::pool_view view;
+    REQUIRE(view.init_from_reserved(base, block_size, block_count));
+    REQUIRE(view.free_count() == block_count);
+
+    auto resident = [&] {
+        std::vector<unsigned char> vec(bytes / page_size);
+        REQUIRE(mincore(base, bytes, vec.data()) == 0);
+        size_t n = 0;
+        for (unsigned char v : vec)
+            n += v & 1;
+        return n;
+    };
+
+    // write through enough blocks to cross several commit chunks
+    constexpr size_t touched = 3 * AL::pool_view::COMMIT_CHUNK / block_size;
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < touched; ++i)
+    {
+        void* p = view.alloc();
+        REQUIRE(p != nullptr);
+        std::memset(p, 0xAB, block_size);
+        ptrs.push_back(p);
+    }
+    REQUIRE(resident() < bytes / page_size / 4);
+
+    // batch allocation commits too
+    std::vector<void*> batch(512);
+    REQUIRE(view.alloc_batch(batch.size(), batch.data()) == batch.size());
+    for (void* p : batch)
+        std::memset(p, 0xCD, block_size);
+
+    view.free_batch(batch);
+    for (void* p : ptrs)
+        view.free(p);
+    REQUIRE(view.free_count() == block_count);
+
+    AL::platform_mem::free(base, bytes);
+}
+
+TEST_CASE("pool_view: prefault touches the next free blocks only", "[pool_view][prefault]")
+{
+    const size_t page_size = AL::platform_mem::page_size();
+    constexpr size_t block_size = 64;
+    constexpr size_t block_count = 64 * 1024;
+    size_t bytes = AL::pool_view::required_region_size(block_size, block_count);
+    bytes = (bytes + page_size - 1) / page_size * page_size;
+
+    void* base = AL::platform_mem::reserve(bytes);
+    REQUIRE(base != nullptr);
+
+    AL::pool_view view;
+    REQUIRE(view.init_from_reserved(base, block_size, block_count));
+
+    auto resident = [&] {
+        std::vector<unsigned char> vec(bytes / page_size);
+        REQUIRE(mincore(base, bytes, vec.data()) == 0);
+        size_t n = 0;
+        for (unsigned char v : vec)
+            n += v & 1;
+        return n;
+    };
+
+    const size_t before = resident();
+    constexpr size_t warm = 2 * AL::pool_view::COMMIT_CHUNK / block_size;
+    REQUIRE(view.prefault(warm) == warm);
+    REQUIRE(resident() >= before + warm * block_size / page_size);
+    REQUIRE(resident() < bytes / page_size / 4);
+    // nothing was handed out, and a reserved region stays zero
+    REQUIRE(view.free_count() == block_count);
+    REQUIRE(view.pristine_count() == block_count);
+
+    // the prefaulted blocks are the ones alloc hands out next
+    const size_t warmed = resident();
+    for (size_t i = 0; i < warm; ++i)
+        REQUIRE(view.alloc() != nullptr);
+    REQUIRE(resident() == warmed);
+
+    AL::platform_mem::free(base, bytes);
+}
+
+TEST_CASE("pool_view: prefault keeps free block contents and stops at the free count", "[pool_view][prefault]")
+{
+    constexpr size_t block_size = 64;
+    constexpr size_t block_count = 100;
+    auto buf = make_region(block_size, block_count);
+    AL::pool_view view;
+    view.init_from_region(block_aligned_base(buf, block_size), block_size, block_count);
+
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < block_count; ++i)
+    {
+        void* p = view.alloc();
+        std::memset(p, static_cast<int>(i), block_size);
+        ptrs.push_back(p);
+    }
+    // free every other block, the rest stay in use
+    for (size_t i = 0; i < block_count; i += 2)
+        view.free(ptrs[i]);
+
+    REQUIRE(view.prefault(10) == 10);
+    REQUIRE(view.prefault(block_count) == block_count / 2);
+    for (size_t i = 0; i < block_count; ++i)
+    {
+        auto* bytes = static_cast<unsigned char*>(ptrs[i]);
+        REQUIRE(bytes[0] == static_cast<unsigned char>(i));
+        REQUIRE(bytes[block_size - 1] == static_cast<unsigned char>(i));
+    }
+    REQUIRE(view.free_count() == block_count / 2);
+    REQUIRE(view.prefault(0) == 0);
+}
+
+TEST_CASE("pool_view: calloc skips never-used blocks of a zeroed region", "[pool_view][calloc]")
+{
+    auto buf = make_region(64, 10);
+    void* base = block_aligned_base(buf, 64);
+
+    AL::pool_view view;
+    view.init_from_region(base, 64, 10, true);
+    REQUIRE(view.pristine_count() == 10);
+
+    bool is_zero = false;
+    void* a = view.alloc(is_zero);
+    REQUIRE(is_zero);
+    REQUIRE(view.pristine_count() == 9);
+
+    // a recycled block is dirty and gets cleared
+    std::memset(a, 0xAB, 64);
+    view.free(a);
+    REQUIRE(view.alloc(is_zero) == a);
+    REQUIRE_FALSE(is_zero);
+    view.free(a);
+
+    auto* c = static_cast<unsigned char*>(view.calloc());
+    REQUIRE(c == a);
+    for (size_t i = 0; i < 64; ++i)
+        REQUIRE(c[i] == 0);
+
+    // the pristine path takes the floor block even with lower blocks free
+    view.free(c);
+    void* pristine = view.alloc_pristine();
+    REQUIRE(pristine == static_cast<std::byte*>(a) + 64);
+    REQUIRE(view.pristine_count() == 8);
+    REQUIRE(view.free_count() == 9);
+
+    // batches raise the floor past their highest block
+    void* out[10];
+    REQUIRE(view.alloc_batch(9, out) == 9);
+    REQUIRE(view.pristine_count() == 0);
+    REQUIRE(view.alloc_pristine() == nullptr);
+
+    // reset keeps the floor, the blocks below it have been written
+    view.reset();
+    REQUIRE(view.pristine_count() == 0);
+}
+
+TEST_CASE("pool_view: calloc clears every block of an unknown region", "[pool_view][calloc]")
+{
+    auto buf = make_region(4096, 4);
+    std::memset(buf.data(), 0xFF, buf.size());
+    void* base = block_aligned_base(buf, 4096);
+
+    AL::pool_view view;
+    view.init_from_region(base, 4096, 4);
+    REQUIRE(view.pristine_count() == 0);
+    REQUIRE(view.alloc_pristine() == nullptr);
+
+    // page sized blocks go through the streaming path
+    for (int n = 0; n < 4; ++n)
+    {
+        auto* c = static_cast<unsigned char*>(view.calloc());
+        REQUIRE(c != nullptr);
+        for (size_t i = 0; i < 4096; ++i)
+            REQUIRE(c[i] == 0);
+    }
+}
@@ -0,0 +1,148 @@
+#include "ring_buffer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+const size_t RING_PAGE_SIZE = getpagesize();
+
+TEST_CASE("Ring buffer: Construction", "[ring_buffer][basic]")
+{
+    AL::ring_buffer r(100);
+    REQUIRE(r.get_capacity() == RING_PAGE_SIZE);
+    REQUIRE(r.get_used() == 0);
+
+    AL::ring_buffer big(RING_PAGE_SIZE * 3);
+    REQUIRE(big.get_capacity() == RING_PAGE_SIZE * 4);
+}
+
+TEST_CASE("Ring buffer: Mirror aliases the same pages", "[ring_buffer][mirror]")
+{
+    const size_t size = RING_PAGE_SIZE * 2;
+    auto* base = static_cast<unsigned char*>(AL::platform_mem::alloc_mirrored(size));
+    REQUIRE(base != nullptr);
+
+    base[0] = 0x11;
+    base[size - 1] = 0x22;
+    REQUIRE(base[size] == 0x11);
+    base[size + 5] = 0x33;
+    REQUIRE(base[5] == 0x33);
+    REQUIRE(base[2 * size - 1] == 0x22);
+
+    REQUIRE(AL::platform_mem::free_mirrored(base, size));
+}
+
+TEST_CASE("Ring buffer: FIFO alloc and free", "[ring_buffer][alloc]")
+{
+    AL::ring_buffer r(RING_PAGE_SIZE);
+
+    SECTION("Rejects invalid sizes")
+    {
+        REQUIRE(r.alloc(0) == nullptr);
+        REQUIRE(r.alloc(r.max_record_size() + 1) == nullptr);
+    }
+
+    SECTION("Records are aligned and accounted")
+    {
+        void* a = r.alloc(1);
+        void* b = r.alloc(100);
+        REQUIRE(a != nullptr);
+        REQUIRE(b != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(a) % alignof(std::max_align_t) == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(b) % alignof(std::max_align_t) == 0);
+        REQUIRE(r.get_used() == AL::ring_buffer::record_size(1) + AL::ring_buffer::record_size(100));
+
+        r.free(a);
+        r.free(b);
+        REQUIRE(r.get_used() == 0);
+    }
+
+    SECTION("Full ring refuses until the consumer frees")
+    {
+        std::deque<void*> live;
+        while (void* p = r.alloc(200))
+            live.push_back(p);
+        REQUIRE(!live.empty());
+        REQUIRE(r.alloc(200) == nullptr);
+
+        r.free(live.front());
+        live.pop_front();
+        REQUIRE(r.alloc(200) != nullptr);
+    }
+
+    SECTION("Records crossing the wrap point stay contiguous")
+    {
+        // move the cursor close to the end, then write a record spanning the boundary
+        void* filler = r.alloc(r.get_capacity() - 256);
+        REQUIRE(filler != nullptr);
+        r.free(filler);
+
+        const size_t len = 1024;
+        auto* rec = static_cast<unsigned char*>(r.alloc(len));
+        REQUIRE(rec != nullptr);
+        for (size_t i = 0; i < len; ++i)
+            rec[i] = static_cast<unsigned char>(i);
+        for (size_t i = 0; i < len; ++i)
+            REQUIRE(rec[i] == static_cast<unsigned char>(i));
+        r.free(rec);
+        REQUIRE(r.get_used() == 0);
+    }
+}
+
+TEST_CASE("Ring buffer: Producer and consumer threads", "[ring_buffer][thread]")
+{
+    constexpr uint64_t total = 200'000;
+    AL::ring_buffer r(RING_PAGE_SIZE * 4);
+
+    // pointer hand-off queue between the two threads
+    constexpr size_t queue_size = 1024;
+    std::vector<std::atomic<void*>> queue(queue_size);
+    std::atomic<uint64_t> q_head{0};
+    std::atomic<uint64_t> q_tail{0};
+    std::atomic<bool> ok{true};
+
+    std::thread producer([&] {
+        for (uint64_t seq = 0; seq < total; ++seq)
+        {
+            size_t len = 16 + (seq * 37) % 700;
+            void* p;
+            while ((p = r.alloc(len)) == nullptr)
+                std::this_thread::yield();
+            auto* words = static_cast<uint64_t*>(p);
+            words[0] = seq;
+            static_cast<unsigned char*>(p)[len - 1] = static_cast<unsigned char>(seq);
+
+            uint64_t h = q_head.load(std::memory_order_relaxed);
+            while (h - q_tail.load(std::memory_order_acquire) >= queue_size)
+                std::this_thread::yield();
+            queue[h % queue_size].store(p, std::memory_order_relaxed);
+            q_head.store(h + 1, std::memory_order_release);
+        }
+    });
+
+    std::thread consumer([&] {
+        for (uint64_t seq = 0; seq < total; ++seq)
+        {
+            uint64_t t = q_tail.load(std::memory_order_relaxed);
+            while (q_head.load(std::memory_order_acquire) == t)
+                std::this_thread::yield();
+            void* p = queue[t % queue_size].load(std::memory_order_relaxed);
+            q_tail.store(t + 1, std::memory_order_release);
+
+            size_t len = 16 + (seq * 37) % 700;
+            if (static_cast<uint64_t*>(p)[0] != seq || static_cast<unsigned char*>(p)[len - 1] != static_cast<unsigned char>(seq))
+                ok.store(false, std::memory_order_relaxed);
+            r.free(p);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    REQUIRE(ok.load());
+    REQUIRE(r.get_used() == 0);
+}
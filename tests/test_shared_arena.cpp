@@ -0,0 +1,184 @@
+#include "shared_arena.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+const size_t SHM_PAGE_SIZE = getpagesize();
+
+TEST_CASE("Shared arena: Basic allocation", "[shared_arena][basic]")
+{
+    auto a = AL::shared_arena<>::create(SHM_PAGE_SIZE);
+    REQUIRE(a.get_used() == 0);
+    REQUIRE(a.get_capacity() >= SHM_PAGE_SIZE);
+
+    void* p1 = a.alloc(10);
+    void* p2 = a.alloc(10);
+    REQUIRE(p1 != nullptr);
+    REQUIRE(p2 != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(p1) % alignof(std::max_align_t) == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(p2) % alignof(std::max_align_t) == 0);
+    REQUIRE(a.get_used() == 2 * alignof(std::max_align_t));
+
+    REQUIRE(a.alloc(a.get_capacity() + 1) == nullptr);
+    a.reset();
+    REQUIRE(a.get_used() == 0);
+}
+
+TEST_CASE("Shared arena: Exhaustion", "[shared_arena][edge]")
+{
+    auto a = AL::shared_arena<8>::create(64);
+    size_t n = 0;
+    while (a.alloc(8) != nullptr)
+        ++n;
+    REQUIRE(n == a.get_capacity() / 8);
+    REQUIRE(a.get_used() == a.get_capacity());
+}
+
+TEST_CASE("Shared arena: Mappings agree through offsets", "[shared_arena][offset]")
+{
+    auto a = AL::shared_arena<>::create(SHM_PAGE_SIZE * 4);
+    auto b = AL::shared_arena<>::from_fd(a.fd());
+    REQUIRE(b.get_capacity() == a.get_capacity());
+
+    auto* text = static_cast<char*>(b.alloc(16));
+    std::strcpy(text, "from b");
+    REQUIRE(a.get_used() == b.get_used());
+    REQUIRE(std::strcmp(static_cast<char*>(a.from_offset(b.to_offset(text))), "from b") == 0);
+
+    SECTION("Alignment mismatch is rejected")
+    {
+        REQUIRE_THROWS_AS(AL::shared_arena<8>::from_fd(a.fd()), std::bad_alloc);
+    }
+}
+
+TEST_CASE("Shared arena: A named segment that fails to map is unlinked", "[shared_arena][edge]")
+{
+    std::string name = "/palloc-test-unmappable-" + std::to_string(getpid());
+
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0)
+    {
+        // child: cap the address space just above what is mapped, so the mapping fails after shm_open succeeded
+        unsigned long pages = 0;
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (statm == nullptr || std::fscanf(statm, "%lu", &pages) != 1)
+            _exit(1);
+        std::fclose(statm);
+        rlimit limit{};
+        limit.rlim_cur = limit.rlim_max = pages * SHM_PAGE_SIZE + (64u << 20);
+        if (setrlimit(RLIMIT_AS, &limit) != 0)
+            _exit(2);
+
+        try
+        {
+            auto a = AL::shared_arena<>::create(size_t(1) << 30, name.c_str());
+            _exit(3);
+        }
+        catch (const std::bad_alloc&)
+        {
+            _exit(0);
+        }
+    }
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+
+    // nothing left behind, the name is free again
+    REQUIRE_FALSE(AL::shm_segment::unlink(name.c_str()));
+    auto a = AL::shared_arena<>::create(SHM_PAGE_SIZE, name.c_str());
+    REQUIRE(AL::shm_segment::unlink(name.c_str()));
+}
+
+TEST_CASE("Shared arena: Concurrent bumping from two processes", "[shared_arena][process]")
+{
+    constexpr int per_process = 1000;
+    auto a = AL::shared_arena<8>::create(per_process * 2 * 8);
+
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0)
+    {
+        auto child = AL::shared_arena<8>::from_fd(a.fd());
+        for (int i = 0; i < per_process; ++i)
+        {
+            auto* v = static_cast<uint64_t*>(child.alloc(8));
+            if (v == nullptr)
+                _exit(1);
+            *v = 1;
+        }
+        _exit(0);
+    }
+
+    std::vector<uint64_t*> mine;
+    for (int i = 0; i < per_process; ++i)
+    {
+        auto* v = static_cast<uint64_t*>(a.alloc(8));
+        REQUIRE(v != nullptr);
+        *v = 2;
+        mine.push_back(v);
+    }
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(a.get_used() == per_process * 2 * 8);
+
+    // the child never received one of our slots
+    for (uint64_t* v : mine)
+        REQUIRE(*v == 2);
+}
+
+TEST_CASE("Shared arena: Snapshot and copy-on-write restore", "[shared_arena][snapshot]")
+{
+    std::string path = "/tmp/palloc-arena-snapshot-" + std::to_string(getpid());
+
+    uint64_t table_offset = 0;
+    size_t used = 0;
+    {
+        auto a = AL::shared_arena<>::create(SHM_PAGE_SIZE * 16);
+        auto* table = static_cast<uint64_t*>(a.alloc(100 * sizeof(uint64_t)));
+        for (uint64_t i = 0; i < 100; ++i)
+            table[i] = i * i;
+        table_offset = a.to_offset(table);
+        used = a.get_used();
+        REQUIRE(a.snapshot(path.c_str()));
+    }
+
+    {
+        auto restored = AL::shared_arena<>::restore(path.c_str());
+        REQUIRE(restored.fd() == -1);
+        REQUIRE(restored.get_used() == used);
+        REQUIRE(restored.get_capacity() >= SHM_PAGE_SIZE * 16);
+
+        auto* table = static_cast<uint64_t*>(restored.from_offset(table_offset));
+        for (uint64_t i = 0; i < 100; ++i)
+            REQUIRE(table[i] == i * i);
+
+        // the restored arena keeps allocating past the snapshot, beyond the written bytes too
+        auto* more = static_cast<unsigned char*>(restored.alloc(SHM_PAGE_SIZE * 8));
+        REQUIRE(more != nullptr);
+        REQUIRE(more[0] == 0);
+        std::memset(more, 0xEE, SHM_PAGE_SIZE * 8);
+        table[0] = 12345;
+    }
+
+    // writes stayed private: the file still holds the snapshot
+    auto again = AL::shared_arena<>::restore(path.c_str());
+    REQUIRE(again.get_used() == used);
+    REQUIRE(static_cast<uint64_t*>(again.from_offset(table_offset))[0] == 0);
+
+    REQUIRE_THROWS_AS(AL::shared_arena<8>::restore(path.c_str()), std::bad_alloc);
+    REQUIRE_THROWS_AS(AL::shared_arena<>::restore("/nonexistent/palloc-snapshot"), std::bad_alloc);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,98 @@
+#include "dynamic_slab.h"
+#include "pool.h"
+#include "shared_block.h"
+#include "slab.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace AL;
+
+TEST_CASE("Shared block: Last release returns the block to its pool", "[shared_block][pool]")
+{
+    pool p(64, 8);
+    auto* block = shared_block<pool>::make(p, 48, 3);
+    REQUIRE(block != nullptr);
+    REQUIRE(block->use_count() == 3);
+    REQUIRE(reinterpret_cast<uintptr_t>(block->data()) % 16 == 0);
+    REQUIRE(shared_block<pool>::from_data(block->data()) == block);
+    std::memset(block->data(), 0x3C, 48);
+    REQUIRE(p.get_free_space() == 7 * 64);
+
+    REQUIRE_FALSE(block->release());
+    block->retain();
+    REQUIRE_FALSE(block->release());
+    REQUIRE_FALSE(block->release());
+    REQUIRE(p.get_free_space() == 7 * 64);
+    REQUIRE(block->release());
+    REQUIRE(p.get_free_space() == 8 * 64);
+
+    // the payload plus the header must fit a pool block
+    REQUIRE(shared_block<pool>::make(p, 49) == nullptr);
+    REQUIRE(shared_block<pool>::make(p, 48, 0) == nullptr);
+    REQUIRE(p.get_free_space() == 8 * 64);
+}
+
+TEST_CASE("Shared block: Slab and dynamic_slab owners free with the block's size", "[shared_block][slab]")
+{
+    default_dynamic_slab ds;
+    const size_t free_before = ds.get_total_free();
+    auto* a = shared_block<default_dynamic_slab>::make(ds, 100, 2);
+    REQUIRE(a != nullptr);
+    REQUIRE_FALSE(a->release());
+    REQUIRE(a->release());
+    ds.release_warm();
+    REQUIRE(ds.get_total_free() == free_before);
+
+    default_slab s;
+    auto* b = shared_block<default_slab>::make(s, 200);
+    REQUIRE(b != nullptr);
+    std::memset(b->data(), 1, 200);
+    REQUIRE(b->release());
+}
+
+TEST_CASE("Shared block: Fan-out to several consumer threads", "[shared_block][threads]")
+{
+    constexpr int CONSUMERS = 3;
+    constexpr int MESSAGES = 2000;
+    pool p(64, 256);
+
+    std::vector<shared_block<pool>*> messages;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto* block = shared_block<pool>::make(p, sizeof(uint64_t), CONSUMERS);
+        REQUIRE(block != nullptr);
+        *static_cast<uint64_t*>(block->data()) = static_cast<uint64_t>(i);
+        messages.push_back(block);
+    }
+
+    // every consumer reads every message, whoever releases last frees it
+    std::atomic<uint64_t> sum{0};
+    std::atomic<int> freed{0};
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < CONSUMERS; ++c)
+    {
+        consumers.emplace_back([&] {
+            for (int round = 0; round < MESSAGES / 200; ++round)
+            {
+                for (auto* block : messages)
+                    sum.fetch_add(*static_cast<const uint64_t*>(block->data()), std::memory_order_relaxed);
+            }
+            for (auto* block : messages)
+            {
+                if (block->release())
+                    freed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : consumers)
+        t.join();
+
+    REQUIRE(freed.load() == 200);
+    REQUIRE(sum.load() == static_cast<uint64_t>(CONSUMERS) * (MESSAGES / 200) * (199 * 200 / 2));
+    REQUIRE(p.get_free_space() == 256 * 64);
+}
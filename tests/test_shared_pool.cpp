@@ -0,0 +1,170 @@
+#include "shared_pool.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+TEST_CASE("Shared pool: Basic construction", "[shared_pool][basic]")
+{
+    auto p = AL::shared_pool::create(64, 100);
+    REQUIRE(p.get_block_size() == 64);
+    REQUIRE(p.get_block_count() == 100);
+    REQUIRE(p.get_capacity() == 64 * 100);
+    REQUIRE(p.get_free_space() == 64 * 100);
+    REQUIRE(p.fd() >= 0);
+
+    SECTION("Block size rounds up to a power of two")
+    {
+        auto q = AL::shared_pool::create(100, 10);
+        REQUIRE(q.get_block_size() == 128);
+    }
+}
+
+TEST_CASE("Shared pool: Alloc, exhaustion and free", "[shared_pool][alloc]")
+{
+    auto p = AL::shared_pool::create(32, 130);
+
+    std::set<void*> ptrs;
+    for (int i = 0; i < 130; ++i)
+    {
+        void* ptr = p.alloc();
+        REQUIRE(ptr != nullptr);
+        REQUIRE(p.owns(ptr));
+        REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 32 == 0);
+        ptrs.insert(ptr);
+    }
+    REQUIRE(ptrs.size() == 130);
+    REQUIRE(p.alloc() == nullptr);
+    REQUIRE(p.get_free_space() == 0);
+
+    for (void* ptr : ptrs)
+        p.free(ptr);
+    REQUIRE(p.get_free_space() == 32 * 130);
+
+    auto* zeroed = static_cast<unsigned char*>(p.calloc());
+    REQUIRE(zeroed != nullptr);
+    for (size_t i = 0; i < 32; ++i)
+        REQUIRE(zeroed[i] == 0);
+}
+
+TEST_CASE("Shared pool: Second mapping sees the same state through offsets", "[shared_pool][offset]")
+{
+    auto a = AL::shared_pool::create(64, 64);
+    auto b = AL::shared_pool::from_fd(a.fd());
+    REQUIRE(b.get_block_count() == 64);
+
+    void* pa = a.alloc();
+    REQUIRE(pa != nullptr);
+    std::memset(pa, 0x5A, 64);
+
+    void* pb = b.from_offset(a.to_offset(pa));
+    REQUIRE(pb != pa); // distinct mappings of the same memory
+    REQUIRE(static_cast<unsigned char*>(pb)[63] == 0x5A);
+    REQUIRE(b.get_free_space() == 63 * 64);
+
+    // freed through the other mapping
+    b.free(pb);
+    REQUIRE(a.get_free_space() == 64 * 64);
+}
+
+TEST_CASE("Shared pool: Rejects segments it did not create", "[shared_pool][edge]")
+{
+    auto seg = AL::shm_segment::create(4096);
+    REQUIRE_THROWS_AS(AL::shared_pool::from_fd(seg.fd()), std::bad_alloc);
+}
+
+TEST_CASE("Shared pool: Blocks allocated in a child process are freed by the parent", "[shared_pool][process]")
+{
+    constexpr int count = 50;
+    auto p = AL::shared_pool::create(64, 256);
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0)
+    {
+        // child: attach through the inherited fd, produce messages, report their offsets
+        close(fds[0]);
+        auto child = AL::shared_pool::from_fd(p.fd());
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            auto* msg = static_cast<uint64_t*>(child.alloc());
+            if (msg == nullptr)
+                _exit(1);
+            msg[0] = i * 7;
+            uint64_t off = child.to_offset(msg);
+            if (write(fds[1], &off, sizeof(off)) != sizeof(off))
+                _exit(2);
+        }
+        close(fds[1]);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    std::vector<uint64_t> offsets;
+    uint64_t off;
+    while (read(fds[0], &off, sizeof(off)) == sizeof(off))
+        offsets.push_back(off);
+    close(fds[0]);
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(offsets.size() == count);
+    REQUIRE(p.get_free_space() == (256 - count) * 64);
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        auto* msg = static_cast<uint64_t*>(p.from_offset(offsets[i]));
+        REQUIRE(msg[0] == i * 7);
+        p.free(msg);
+    }
+    REQUIRE(p.get_free_space() == 256 * 64);
+}
+
+TEST_CASE("Shared pool: Snapshot and copy-on-write restore", "[shared_pool][snapshot]")
+{
+    std::string path = "/tmp/palloc-pool-snapshot-" + std::to_string(getpid());
+
+    std::vector<uint64_t> offsets;
+    {
+        auto pool = AL::shared_pool::create(64, 200);
+        for (int i = 0; i < 70; ++i)
+        {
+            auto* block = static_cast<uint64_t*>(pool.alloc());
+            REQUIRE(block != nullptr);
+            block[0] = static_cast<uint64_t>(i);
+            offsets.push_back(pool.to_offset(block));
+        }
+        // a hole in the middle stays free after restore
+        pool.free(pool.from_offset(offsets[10]));
+        REQUIRE(pool.snapshot(path.c_str()));
+    }
+
+    auto restored = AL::shared_pool::restore(path.c_str());
+    REQUIRE(restored.get_block_count() == 200);
+    REQUIRE(restored.get_free_space() == (200 - 69) * 64);
+    for (int i = 0; i < 70; ++i)
+    {
+        if (i != 10)
+            REQUIRE(static_cast<uint64_t*>(restored.from_offset(offsets[i]))[0] == static_cast<uint64_t>(i));
+    }
+
+    // allocation resumes at the freed block, then past the snapshot's last block
+    REQUIRE(restored.to_offset(restored.alloc()) == offsets[10]);
+    for (int i = 0; i < 130; ++i)
+        REQUIRE(restored.alloc() != nullptr);
+    REQUIRE(restored.alloc() == nullptr);
+
+    REQUIRE_THROWS_AS(AL::shared_pool::restore("/nonexistent/palloc-snapshot"), std::bad_alloc);
+    std::remove(path.c_str());
+}
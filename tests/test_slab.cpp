@@ -2,9 +2,19 @@
 #include <catch2/catch_test_macros.hpp>
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <set>
+#include <thread>
 #include <vector>
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 constexpr std::array<AL::size_class, 3> TINY_CONFIG = {
     {
      {.byte_size = 8, .num_blocks = 4, .batch_size = 2},
@@ -799,3 +809,808 @@ TEST_CASE("Slab: Wide sparse config {8, 128, 4096}", "[slab][sparse]")
     s.free(p16, 16);
     s.free(p256, 256);
 }
+
+TEST_CASE("Slab: Lazily committed region", "[slab][commit]")
+{
+    constexpr std::array<AL::size_class, 2> BIG_CONFIG = {
+        {
+         {.byte_size = 64, .num_blocks = 1 << 18, .batch_size = 64},
+         {.byte_size = 4096, .num_blocks = 1 << 12, .batch_size = 8},
+         }
+    };
+    AL::slab<AL::slab_config<2, BIG_CONFIG>> s(AL::mem_flags::lazy_commit);
+    REQUIRE(s.get_total_free() == s.get_total_capacity());
+
+    std::vector<void*> small;
+    std::vector<void*> large;
+    for (int i = 0; i < 5000; ++i)
+    {
+        void* p = s.alloc(64);
+        REQUIRE(p != nullptr);
+        std::memset(p, 1, 64);
+        small.push_back(p);
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        void* p = s.alloc(4096);
+        REQUIRE(p != nullptr);
+        std::memset(p, 2, 4096);
+        large.push_back(p);
+    }
+
+    for (void* p : small)
+        s.free(p, 64);
+    for (void* p : large)
+        s.free(p, 4096);
+}
+
+TEST_CASE("Slab: Huge page backed region", "[slab][flags][huge]")
+{
+    AL::default_slab s(AL::mem_flags::huge_pages);
+    REQUIRE(reinterpret_cast<uintptr_t>(s.region_start()) % AL::platform_mem::huge_page_size == 0);
+    REQUIRE(static_cast<size_t>(s.region_end() - s.region_start()) % AL::platform_mem::huge_page_size == 0);
+
+    void* p = s.alloc(128);
+    REQUIRE(p != nullptr);
+    std::memset(p, 3, 128);
+    REQUIRE(s.get_huge_page_bytes() <= static_cast<size_t>(s.region_end() - s.region_start()));
+    s.free(p, 128);
+}
+
+TEST_CASE("Slab: Built inside a caller buffer", "[slab][nested]")
+{
+    using slab_t = AL::default_slab;
+    std::vector<std::byte> buffer(slab_t::required_buffer_size());
+    {
+        slab_t s(buffer.data(), buffer.size());
+        REQUIRE(s.region_start() >= buffer.data());
+        REQUIRE(s.region_end() <= buffer.data() + buffer.size());
+        REQUIRE(s.get_total_free() == s.get_total_capacity());
+
+        void* p = s.alloc(100);
+        REQUIRE(p != nullptr);
+        REQUIRE(s.owns(p));
+        std::memset(p, 7, 100);
+        s.free(p, 100);
+    }
+    // the slab never released the buffer, it can be reused right away
+    slab_t again(buffer.data(), buffer.size());
+    REQUIRE(again.alloc(8) != nullptr);
+
+    REQUIRE_THROWS_AS(slab_t(buffer.data(), buffer.size() / 2), std::bad_alloc);
+}
+
+TEST_CASE("Slab: Built inside a parent arena", "[slab][nested]")
+{
+    using slab_t = AL::default_slab;
+    AL::arena parent(slab_t::required_buffer_size() * 3);
+
+    for (int round = 0; round < 4; ++round)
+    {
+        {
+            slab_t a(parent);
+            slab_t b(parent);
+            void* pa = a.alloc(64);
+            void* pb = b.alloc(64);
+            REQUIRE(pa != nullptr);
+            REQUIRE(pb != nullptr);
+            REQUIRE(a.owns(pa));
+            REQUIRE_FALSE(a.owns(pb));
+            a.free(pa, 64);
+            b.free(pb, 64);
+        }
+        // throw every nested slab away at once
+        parent.reset();
+    }
+
+    slab_t a(parent);
+    slab_t b(parent);
+    slab_t c(parent);
+    REQUIRE_THROWS_AS(slab_t(parent), std::bad_alloc);
+}
+
+#ifdef __linux__
+// counts user-space instructions retired by this thread. invalid if the kernel or hardware has no counters
+struct instruction_counter
+{
+    int fd = -1;
+
+    instruction_counter()
+    {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~instruction_counter()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    template<typename Tfn>
+    uint64_t measure(Tfn&& fn)
+    {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        fn();
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count))
+            return 0;
+        return count;
+    }
+};
+
+TEST_CASE("Slab: Fast path instruction budget", "[slab][perf]")
+{
+#ifndef __OPTIMIZE__
+    SKIP("instruction budget only applies to optimized builds");
+#endif
+    instruction_counter counter;
+    if (counter.fd < 0)
+        SKIP("perf_event_open unavailable (no hardware counters or perf_event_paranoid too strict)");
+
+    AL::default_slab s;
+    // warm the thread cache so every iteration stays on the fast path
+    void* warm = s.alloc(64);
+    REQUIRE(warm != nullptr);
+    s.free(warm, 64);
+
+    constexpr int ITERATIONS = 100000;
+    void* volatile sink = nullptr;
+    uint64_t total = counter.measure(
+        [&]
+        {
+            for (int i = 0; i < ITERATIONS; ++i)
+            {
+                void* p = s.alloc(64);
+                sink = p;
+                s.free(p, 64);
+            }
+        });
+
+    // size -> index -> TLC pop + push is ~40 instructions. the slow path (slot scan, refill, epoch sync)
+    // leaking back into the inlined body would blow well past this
+    const double per_pair = static_cast<double>(total) / ITERATIONS;
+    INFO("instructions per alloc/free pair: " << per_pair);
+    REQUIRE(per_pair < 80.0);
+}
+#endif
+
+TEST_CASE("Slab: Compile-time size class entry points", "[slab][static]")
+{
+    using slab_t = AL::slab<AL::slab_config<3, TINY_CONFIG>>;
+    static_assert(slab_t::class_index<1>() == 0);
+    static_assert(slab_t::class_index<9>() == 1);
+    static_assert(slab_t::class_index<32>() == 2);
+
+    slab_t s;
+
+    SECTION("alloc<N> draws from the class alloc(N) would")
+    {
+        std::set<void*> seen;
+        for (int i = 0; i < 4; ++i)
+        {
+            void* p = s.alloc<12>();
+            REQUIRE(p != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(p) % 16 == 0);
+            REQUIRE(s.owns(p));
+            REQUIRE(seen.insert(p).second);
+        }
+        // the 16 byte class only has 4 blocks
+        REQUIRE(s.alloc<16>() == nullptr);
+        REQUIRE(s.alloc(16) == nullptr);
+
+        for (void* p : seen)
+            s.free<16>(p);
+        void* reused = s.alloc(13);
+        REQUIRE(seen.count(reused) == 1);
+    }
+
+    SECTION("compile-time and runtime paths mix freely")
+    {
+        void* a = s.alloc<8>();
+        void* b = s.alloc(8);
+        void* c = s.alloc_class<0>();
+        REQUIRE(a != nullptr);
+        REQUIRE(b != nullptr);
+        REQUIRE(c != nullptr);
+        s.free(a, 8);
+        s.free<8>(b);
+        s.free_class<0>(c);
+
+        std::set<void*> again;
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(again.insert(s.alloc<8>()).second);
+        REQUIRE(again.count(nullptr) == 0);
+        for (void* p : again)
+            s.free_class<0>(p);
+    }
+}
+
+TEST_CASE("Slab: Compile-time entry points on uncached classes", "[slab][static]")
+{
+    // only the first class goes through the thread cache
+    using slab_t = AL::slab<AL::slab_config<3, TINY_CONFIG, 1>>;
+    slab_t s;
+
+    void* p = s.alloc<32>();
+    REQUIRE(p != nullptr);
+    REQUIRE(s.get_pool_free_space(2) == 32 * 3);
+    s.free<32>(p);
+    REQUIRE(s.get_pool_free_space(2) == 32 * 4);
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Bulk alloc / free
+// ──────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("Slab: Bulk alloc and free", "[slab][bulk]")
+{
+    large_slab s;
+    std::vector<void*> ptrs(200);
+
+    REQUIRE(s.alloc_bulk(64, ptrs.size(), ptrs.data()) == ptrs.size());
+    // the cache was empty, so everything came from the pool in one batch
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 200) * 64);
+
+    std::set<void*> unique(ptrs.begin(), ptrs.end());
+    REQUIRE(unique.size() == ptrs.size());
+    for (size_t i = 0; i < ptrs.size(); ++i)
+    {
+        REQUIRE(s.owns(ptrs[i]));
+        std::memset(ptrs[i], static_cast<int>(i & 0xFF), 64);
+    }
+    for (size_t i = 0; i < ptrs.size(); ++i)
+        REQUIRE(static_cast<unsigned char*>(ptrs[i])[63] == static_cast<unsigned char>(i & 0xFF));
+
+    // the cache takes what fits, the rest goes straight back to the pool
+    s.free_bulk(64, ptrs.data(), ptrs.size());
+    REQUIRE(s.get_pool_free_space(0) == (1024 - AL::thread_local_cache::object_count) * 64);
+
+    // the cached blocks are handed out again before the pool is touched
+    std::vector<void*> again(AL::thread_local_cache::object_count);
+    REQUIRE(s.alloc_bulk(64, again.size(), again.data()) == again.size());
+    REQUIRE(s.get_pool_free_space(0) == (1024 - AL::thread_local_cache::object_count) * 64);
+    for (void* p : again)
+        REQUIRE(unique.count(p) == 1);
+
+    // single alloc/free mix with the bulk calls
+    void* single = s.alloc(64);
+    REQUIRE(single != nullptr);
+    s.free(single, 64);
+    s.free_bulk(64, again.data(), again.size());
+}
+
+TEST_CASE("Slab: Bulk alloc stops at pool exhaustion", "[slab][bulk][edge]")
+{
+    tiny_slab s;
+    void* ptrs[8] = {};
+
+    REQUIRE(s.alloc_bulk(8, 8, ptrs) == 4);
+    REQUIRE(s.alloc(8) == nullptr);
+
+    // nullptr entries are skipped
+    s.free_bulk(8, ptrs, 8);
+    REQUIRE(s.alloc_bulk(8, 4, ptrs) == 4);
+    s.free_bulk(8, ptrs, 4);
+
+    REQUIRE(s.alloc_bulk(0, 4, ptrs) == 0);
+    REQUIRE(s.alloc_bulk(64, 4, ptrs) == 0);
+    REQUIRE(s.alloc_bulk(8, 0, ptrs) == 0);
+}
+
+TEST_CASE("Slab: Bulk alloc and free on uncached classes", "[slab][bulk]")
+{
+    using slab_t = AL::slab<AL::slab_config<3, TINY_CONFIG, 1>>;
+    slab_t s;
+    void* ptrs[4] = {};
+
+    REQUIRE(s.alloc_bulk(32, 4, ptrs) == 4);
+    REQUIRE(s.get_pool_free_space(2) == 0);
+    s.free_bulk(32, ptrs, 4);
+    REQUIRE(s.get_pool_free_space(2) == 32 * 4);
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Spill to larger classes
+// ──────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("Slab: Exhausted class spills into the next larger one", "[slab][spill]")
+{
+    // no thread cache, so pool free space shows exactly where each block came from
+    using slab_t = AL::slab<AL::slab_config<3, TINY_CONFIG, 0, 1>>;
+    slab_t s;
+
+    std::vector<void*> exact;
+    for (int i = 0; i < 4; ++i)
+        exact.push_back(s.alloc(8));
+    REQUIRE(s.get_pool_free_space(0) == 0);
+
+    void* spilled = s.alloc(8);
+    REQUIRE(spilled != nullptr);
+    REQUIRE(s.get_pool_free_space(1) == 16 * 3);
+
+    // a spill of 1 never reaches the 32 byte class
+    std::vector<void*> more;
+    while (void* p = s.alloc(8))
+        more.push_back(p);
+    REQUIRE(more.size() == 3);
+    REQUIRE(s.get_pool_free_space(2) == 32 * 4);
+
+    // free with the requested size goes back to the class the block came from
+    s.free(spilled, 8);
+    REQUIRE(s.get_pool_free_space(1) == 16);
+    REQUIRE(s.get_pool_free_space(0) == 0);
+    s.free<8>(more[0]);
+    REQUIRE(s.get_pool_free_space(1) == 32);
+
+    // free_bulk splits mixed runs
+    exact.push_back(more[1]);
+    exact.push_back(more[2]);
+    s.free_bulk(8, exact.data(), exact.size());
+    REQUIRE(s.get_pool_free_space(0) == 8 * 4);
+    REQUIRE(s.get_pool_free_space(1) == 16 * 4);
+}
+
+TEST_CASE("Slab: Spilled blocks return through the thread cache", "[slab][spill][tlc]")
+{
+    using slab_t = AL::slab<AL::slab_config<3, TINY_CONFIG, 3, 2>>;
+    slab_t s;
+
+    std::set<void*> ptrs;
+    while (void* p = s.alloc(8))
+    {
+        REQUIRE(s.owns(p));
+        ptrs.insert(p);
+    }
+    // every class was reachable
+    REQUIRE(ptrs.size() == 12);
+
+    for (void* p : ptrs)
+        s.free(p, 8);
+
+    // each block sits in its own class's cache, so exact allocations still find them
+    std::vector<void*> reuse;
+    for (size_t size : {32, 32, 32, 32, 16, 16, 16, 16})
+    {
+        void* p = s.alloc(size);
+        REQUIRE(p != nullptr);
+        REQUIRE(ptrs.count(p) == 1);
+        reuse.push_back(p);
+    }
+    REQUIRE(s.alloc(32) == nullptr);
+
+    // bulk allocs spill too
+    void* out[8] = {};
+    REQUIRE(s.alloc_bulk(8, 8, out) == 4);
+    s.free_bulk(8, out, 4);
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Deferred free
+// ──────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("Slab: Deferred frees are released by drain", "[slab][deferred]")
+{
+    // uncached, so pool free space shows exactly when blocks come back
+    using slab_t = AL::slab<AL::slab_config<2, LARGE_CONFIG, 0>>;
+    slab_t s;
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 100; ++i)
+        ptrs.push_back(s.alloc(i % 2 ? 64 : 128));
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 50) * 64);
+    REQUIRE(s.get_pool_free_space(1) == (1024 - 50) * 128);
+
+    for (int i = 0; i < 100; ++i)
+        s.free_deferred(ptrs[i], i % 2 ? 64 : 128);
+    REQUIRE(s.get_deferred_count() == 100);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 50) * 64);
+
+    s.drain();
+    REQUIRE(s.get_deferred_count() == 0);
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+    REQUIRE(s.get_pool_free_space(1) == 1024 * 128);
+
+    // nothing pending is a no-op
+    s.drain();
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+}
+
+TEST_CASE("Slab: Deferred buffer drains itself when full", "[slab][deferred]")
+{
+    using slab_t = AL::slab<AL::slab_config<2, LARGE_CONFIG, 0>>;
+    slab_t s;
+    const size_t n = slab_t::DEFERRED_CAPACITY + 10;
+
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < n; ++i)
+        ptrs.push_back(s.alloc(64));
+    for (void* p : ptrs)
+        s.free_deferred(p, 64);
+
+    REQUIRE(s.get_deferred_count() == 10);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 10) * 64);
+    s.drain();
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+}
+
+TEST_CASE("Slab: Slabs of one type share the thread's deferred buffer", "[slab][deferred]")
+{
+    using slab_t = AL::slab<AL::slab_config<2, LARGE_CONFIG, 0>>;
+    slab_t a;
+    slab_t b;
+    void* pa = a.alloc(64);
+    void* pb = b.alloc(128);
+
+    a.free_deferred(pa, 64);
+    b.free_deferred(pb, 128);
+    REQUIRE(a.get_deferred_count() == 1);
+    REQUIRE(b.get_deferred_count() == 1);
+
+    // draining either one releases both
+    a.drain();
+    REQUIRE(b.get_deferred_count() == 0);
+    REQUIRE(a.get_pool_free_space(0) == 1024 * 64);
+    REQUIRE(b.get_pool_free_space(1) == 1024 * 128);
+
+    // a slab going away takes its pending frees with it, the others stay
+    void* pc = a.alloc(64);
+    a.free_deferred(pc, 64);
+    {
+        slab_t c;
+        c.free_deferred(c.alloc(64), 64);
+        REQUIRE(c.get_deferred_count() == 1);
+    }
+    REQUIRE(a.get_deferred_count() == 1);
+    a.drain();
+    REQUIRE(a.get_pool_free_space(0) == 1024 * 64);
+}
+
+TEST_CASE("Slab: A thread's pending deferred frees are released when it exits", "[slab][deferred][threads]")
+{
+    using slab_t = AL::slab<AL::slab_config<2, LARGE_CONFIG, 0>>;
+    slab_t s;
+
+    std::thread worker([&s] {
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 100; ++i)
+            ptrs.push_back(s.alloc(i % 2 ? 64 : 128));
+        for (int i = 0; i < 100; ++i)
+            s.free_deferred(ptrs[i], i % 2 ? 64 : 128);
+        // exits without drain()
+    });
+    worker.join();
+
+    REQUIRE(s.get_deferred_count() == 0);
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+    REQUIRE(s.get_pool_free_space(1) == 1024 * 128);
+}
+
+TEST_CASE("Slab: Deferred frees go through the thread cache", "[slab][deferred][tlc]")
+{
+    large_slab s;
+    std::set<void*> ptrs;
+    for (int i = 0; i < 64; ++i)
+        ptrs.insert(s.alloc(64));
+    for (void* p : ptrs)
+        s.free_deferred(p, 64);
+
+    s.drain();
+    // the drained blocks are what the next allocations get back
+    for (int i = 0; i < 64; ++i)
+        REQUIRE(ptrs.count(s.alloc(64)) == 1);
+}
+
+TEST_CASE("Slab: Reset drops pending deferred frees", "[slab][deferred][reset]")
+{
+    using slab_t = AL::slab<AL::slab_config<2, LARGE_CONFIG, 0>>;
+    slab_t s;
+    void* p = s.alloc(64);
+    s.free_deferred(p, 64);
+    REQUIRE(s.get_deferred_count() == 1);
+
+    s.reset();
+    REQUIRE(s.get_deferred_count() == 0);
+    s.drain();
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+
+    // invalid input is ignored
+    s.free_deferred(nullptr, 64);
+    s.free_deferred(s.alloc(64), 0);
+    REQUIRE(s.get_deferred_count() == 0);
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Calloc zero tracking
+// ──────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("Slab: Calloc takes never-used blocks and clears recycled ones", "[slab][calloc]")
+{
+    AL::default_slab s;
+    const size_t index = AL::default_slab::size_to_index(4096);
+    const size_t blocks = s.get_pool_free_space(index) / 4096;
+
+    auto all_zero = [](void* p, size_t n) {
+        auto* bytes = static_cast<unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i)
+            if (bytes[i] != 0)
+                return false;
+        return true;
+    };
+
+    // a dirty block in the thread cache is passed over while pristine blocks remain
+    void* dirty = s.alloc(4096);
+    std::memset(dirty, 0xAB, 4096);
+    s.free(dirty, 4096);
+
+    std::vector<void*> ptrs;
+    while (void* p = s.calloc(4096))
+    {
+        REQUIRE(all_zero(p, 4096));
+        std::memset(p, 0xCD, 4096);
+        ptrs.push_back(p);
+    }
+    REQUIRE(ptrs.size() == blocks);
+
+    for (void* p : ptrs)
+        s.free(p, 4096);
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        void* p = s.calloc(4096);
+        REQUIRE(p != nullptr);
+        REQUIRE(all_zero(p, 4096));
+    }
+}
+
+TEST_CASE("Slab: Calloc keeps using never-used blocks after a refused commit", "[slab][calloc][no_syscall]")
+{
+    constexpr std::array<AL::size_class, 1> PAGE_CLASS = {
+        {{.byte_size = 4096, .num_blocks = 64, .batch_size = 4}}
+    };
+    AL::slab<AL::slab_config<1, PAGE_CLASS>> s(AL::mem_flags::lazy_commit);
+    const size_t free_before = s.get_pool_free_space(0);
+
+    {
+        AL::no_syscall_scope scope;
+        REQUIRE(s.calloc(4096) == nullptr);
+        REQUIRE(scope.refusals() > 0);
+    }
+    REQUIRE(s.get_pool_free_space(0) == free_before);
+
+    // still one block straight from the pool, not a refill of a whole batch
+    void* p = s.calloc(4096);
+    REQUIRE(p != nullptr);
+    REQUIRE(s.get_pool_free_space(0) == free_before - 4096);
+    s.free(p, 4096);
+}
+
+TEST_CASE("Slab: Calloc in a caller buffer always clears", "[slab][calloc][nested]")
+{
+    std::vector<std::byte> buffer(tiny_slab::required_buffer_size());
+    std::memset(buffer.data(), 0xFF, buffer.size());
+    tiny_slab s(buffer.data(), buffer.size());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto* p = static_cast<unsigned char*>(s.calloc(32));
+        REQUIRE(p != nullptr);
+        for (size_t j = 0; j < 32; ++j)
+            REQUIRE(p[j] == 0);
+    }
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Intrusive thread cache
+// ──────────────────────────────────────────────────────────────────────────────
+
+using intrusive_large_slab = AL::slab<AL::slab_config<2, LARGE_CONFIG, 2, 0, AL::tlc_storage::intrusive>>;
+using intrusive_tiny_slab = AL::slab<AL::slab_config<3, TINY_CONFIG, 3, 0, AL::tlc_storage::intrusive>>;
+
+TEST_CASE("Slab: Intrusive TLC costs three words per class", "[slab][tlc][intrusive]")
+{
+    STATIC_REQUIRE(sizeof(AL::intrusive_local_cache) == 3 * sizeof(void*));
+    STATIC_REQUIRE(sizeof(AL::intrusive_local_cache) * 8 < sizeof(AL::thread_local_cache));
+}
+
+TEST_CASE("Slab: Intrusive TLC holds up to two batches", "[slab][tlc][intrusive]")
+{
+    intrusive_large_slab s;
+
+    // one refill is one batch
+    void* first = s.alloc(64);
+    REQUIRE(first != nullptr);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 64) * 64);
+    s.free(first, 64);
+    REQUIRE(s.alloc(64) == first);
+    s.free(first, 64);
+
+    std::vector<void*> ptrs(200);
+    REQUIRE(s.alloc_bulk(64, ptrs.size(), ptrs.data()) == ptrs.size());
+    std::set<void*> unique(ptrs.begin(), ptrs.end());
+    REQUIRE(unique.size() == ptrs.size());
+    for (size_t i = 0; i < ptrs.size(); ++i)
+        std::memset(ptrs[i], static_cast<int>(i & 0xFF), 64);
+    for (size_t i = 0; i < ptrs.size(); ++i)
+        REQUIRE(static_cast<unsigned char*>(ptrs[i])[0] == static_cast<unsigned char>(i & 0xFF));
+
+    // the cache keeps two batches, the rest goes back to the pool
+    s.free_bulk(64, ptrs.data(), ptrs.size());
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 128) * 64);
+
+    // 128 come from the cache, the next one refills a batch from the pool
+    std::vector<void*> again;
+    for (int i = 0; i < 129; ++i)
+        again.push_back(s.alloc(64));
+    REQUIRE(std::set<void*>(again.begin(), again.end()).size() == again.size());
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 192) * 64);
+
+    // 63 of that batch are still cached, 65 frees fill the cache and the next one hands a batch back
+    for (int i = 0; i < 65; ++i)
+        s.free(again[i], 64);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 192) * 64);
+    s.free(again[65], 64);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 128) * 64);
+    for (size_t i = 66; i < again.size(); ++i)
+        s.free(again[i], 64);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 128) * 64);
+}
+
+TEST_CASE("Slab: Intrusive TLC is dropped on reset", "[slab][tlc][intrusive][reset]")
+{
+    intrusive_tiny_slab s;
+    for (int round = 0; round < 3; ++round)
+    {
+        std::set<void*> ptrs;
+        for (int i = 0; i < 4; ++i)
+            ptrs.insert(s.alloc(8));
+        REQUIRE(ptrs.size() == 4);
+        REQUIRE(ptrs.count(nullptr) == 0);
+        REQUIRE(s.alloc(8) == nullptr);
+
+        for (void* p : ptrs)
+            s.free(p, 8);
+        s.reset();
+    }
+}
+
+TEST_CASE("Slab: Evicted intrusive TLC returns its blocks", "[slab][tlc][intrusive]")
+{
+    std::vector<std::unique_ptr<intrusive_large_slab>> slabs;
+    for (int i = 0; i < 4; ++i)
+    {
+        slabs.push_back(std::make_unique<intrusive_large_slab>());
+        slabs.back()->free(slabs.back()->alloc(64), 64);
+        REQUIRE(slabs.back()->get_pool_free_space(0) == (1024 - 64) * 64);
+    }
+
+    // a fifth slab takes the last cache slot, flushing whichever slab held it
+    intrusive_large_slab fifth;
+    fifth.free(fifth.alloc(64), 64);
+
+    int flushed = 0;
+    for (auto& s : slabs)
+        flushed += s->get_pool_free_space(0) == 1024 * 64;
+    REQUIRE(flushed == 1);
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Prewarm
+// ──────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("Slab: Prewarm fills the thread cache and release_warm empties it", "[slab][prewarm]")
+{
+    large_slab s;
+    REQUIRE(s.prewarm({200, 0}) == 200);
+    // the cache holds 128, the next 72 are only prefaulted in the pool
+    REQUIRE(s.get_pool_free_space(0) == (1024 - AL::thread_local_cache::object_count) * 64);
+    REQUIRE(s.get_pool_free_space(1) == 1024 * 128);
+
+    // the first allocations never touch the pool
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < AL::thread_local_cache::object_count; ++i)
+        ptrs.push_back(s.alloc(64));
+    REQUIRE(s.get_pool_free_space(0) == (1024 - AL::thread_local_cache::object_count) * 64);
+    REQUIRE(std::set<void*>(ptrs.begin(), ptrs.end()).size() == ptrs.size());
+
+    // prewarming again only tops up
+    REQUIRE(s.prewarm({10, 0}) == 10);
+    for (void* p : ptrs)
+        s.free(p, 64);
+
+    s.release_warm();
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+    s.release_warm();
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+}
+
+TEST_CASE("Slab: Prewarm on intrusive and uncached classes", "[slab][prewarm]")
+{
+    intrusive_large_slab s;
+    // the intrusive cache holds two batches
+    REQUIRE(s.prewarm({200, 0}) == 200);
+    REQUIRE(s.get_pool_free_space(0) == (1024 - 128) * 64);
+    s.release_warm();
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64);
+
+    // uncached classes are only prefaulted, and a pool can't cover more than it has
+    using slab_t = AL::slab<AL::slab_config<2, LARGE_CONFIG, 0>>;
+    slab_t u;
+    REQUIRE(u.prewarm({10, 5000}) == 10 + 1024);
+    REQUIRE(u.get_total_free() == u.get_total_capacity());
+}
+
+#ifdef __linux__
+constexpr std::array<AL::size_class, 1> PAGES_CONFIG = {
+    {
+     {.byte_size = 8192, .num_blocks = 64, .batch_size = 4},
+     }
+};
+
+// every page under the block is resident
+static bool block_resident(void* ptr, size_t bytes)
+{
+    const size_t page = AL::platform_mem::page_size();
+    std::vector<unsigned char> vec((bytes + page - 1) / page);
+    if (mincore(ptr, bytes, vec.data()) != 0)
+        return false;
+    for (unsigned char v : vec)
+    {
+        if ((v & 1) == 0)
+            return false;
+    }
+    return true;
+}
+
+template<typename Tslab>
+static void check_prewarm_touches_cached_blocks()
+{
+    Tslab s;
+    // the refill behind this leaves three blocks in the cache that nobody has written
+    void* first = s.alloc(8192);
+    REQUIRE(first != nullptr);
+    REQUIRE(s.prewarm({3}) == 3);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        void* p = s.alloc(8192);
+        REQUIRE(p != nullptr);
+        REQUIRE(block_resident(p, 8192));
+        s.free(p, 8192);
+    }
+    s.free(first, 8192);
+}
+
+TEST_CASE("Slab: Prewarm touches blocks already in the cache", "[slab][prewarm]")
+{
+    SECTION("Array cache")
+    {
+        check_prewarm_touches_cached_blocks<AL::slab<AL::slab_config<1, PAGES_CONFIG>>>();
+    }
+    SECTION("Intrusive cache")
+    {
+        check_prewarm_touches_cached_blocks<AL::slab<AL::slab_config<1, PAGES_CONFIG, 1, 0, AL::tlc_storage::intrusive>>>();
+    }
+}
+#endif
+
+TEST_CASE("Slab: Release_warm after reset frees nothing twice", "[slab][prewarm][reset]")
+{
+    large_slab s;
+    REQUIRE(s.prewarm({64, 64}) == 128);
+    s.reset();
+    REQUIRE(s.get_total_free() == s.get_total_capacity());
+
+    void* p = s.alloc(64);
+    REQUIRE(p != nullptr);
+    s.release_warm();
+    // the block just allocated is still out
+    REQUIRE(s.get_pool_free_space(0) == 1024 * 64 - 64);
+    s.free(p, 64);
+}
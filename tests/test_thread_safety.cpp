@@ -65,6 +65,7 @@ constexpr std::array<AL::size_class, 10> HIGH_CAP_CONFIG = {{
     {.byte_size = 4096, .num_blocks =  128, .batch_size =  4},
 }};
 using high_cap_slab = AL::slab<AL::slab_config<10, HIGH_CAP_CONFIG>>;
+using intrusive_high_cap_slab = AL::slab<AL::slab_config<10, HIGH_CAP_CONFIG, 10, 0, AL::tlc_storage::intrusive>>;
 
 size_t slab_class_size(size_t requested)
 {
@@ -1959,4 +1960,94 @@ TEST_CASE("Slab thread safety: alloc-only burst then bulk free", "[slab][thread]
         t.join();
 }
 
+TEST_CASE("Slab thread safety: intrusive TLC with cross-thread frees", "[slab][thread][intrusive]")
+{
+    const size_t threads = worker_count();
+    const size_t allocs_per_thread = 200;
+    intrusive_high_cap_slab slab;
+
+    struct alloc_record
+    {
+        std::byte* ptr;
+        size_t sz;
+        std::byte pattern;
+    };
+
+    std::atomic<bool> start{false};
+    std::atomic<size_t> corruption{0};
+    std::vector<std::vector<alloc_record>> allocated(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    // Phase 1: every thread allocates and fills its blocks
+    for (size_t tid = 0; tid < threads; ++tid)
+    {
+        workers.emplace_back([&, tid] {
+            auto& local = allocated[tid];
+            local.reserve(allocs_per_thread);
+            wait_for_start(start);
+            for (size_t i = 0; i < allocs_per_thread; ++i)
+            {
+                size_t sz = SLAB_SIZE_CLASSES[(tid + i) % SLAB_SIZE_CLASSES.size()];
+                auto* ptr = static_cast<std::byte*>(slab.alloc(sz));
+                if (ptr == nullptr)
+                    continue;
+                std::byte pattern = static_cast<std::byte>((tid * 13 + i) & 0xFF);
+                std::memset(ptr, static_cast<int>(pattern), sz);
+                local.push_back({ptr, sz, pattern});
+            }
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    for (auto& t : workers)
+        t.join();
+
+    // Phase 2: each thread checks and frees its neighbour's blocks, threading them into its own cache,
+    // then allocates again from that cache and checks nothing it still holds was overwritten
+    start.store(false);
+    workers.clear();
+    for (size_t tid = 0; tid < threads; ++tid)
+    {
+        workers.emplace_back([&, tid] {
+            wait_for_start(start);
+            for (const auto& rec : allocated[(tid + 1) % threads])
+            {
+                for (size_t j = 0; j < rec.sz; ++j)
+                {
+                    if (rec.ptr[j] != rec.pattern)
+                    {
+                        corruption.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+                slab.free(rec.ptr, rec.sz);
+            }
+
+            std::vector<alloc_record> again;
+            for (size_t i = 0; i < allocs_per_thread; ++i)
+            {
+                size_t sz = SLAB_SIZE_CLASSES[i % SLAB_SIZE_CLASSES.size()];
+                auto* ptr = static_cast<std::byte*>(slab.alloc(sz));
+                if (ptr == nullptr)
+                    continue;
+                std::memset(ptr, static_cast<int>(tid & 0xFF), sz);
+                again.push_back({ptr, sz, static_cast<std::byte>(tid & 0xFF)});
+            }
+            for (const auto& rec : again)
+            {
+                if (rec.ptr[rec.sz - 1] != rec.pattern || rec.ptr[0] != rec.pattern)
+                    corruption.fetch_add(1, std::memory_order_relaxed);
+                slab.free(rec.ptr, rec.sz);
+            }
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    for (auto& t : workers)
+        t.join();
+
+    REQUIRE(corruption.load() == 0);
+}
+
 #endif // !defined(PALLOC_SINGLE_THREADED)
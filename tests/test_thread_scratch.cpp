@@ -0,0 +1,143 @@
+#include "thread_scratch.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+using namespace AL;
+
+static const size_t PAGE_SIZE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+// one page chunks, so tests can see growth and trimming
+using small_scratch = thread_scratch<16, 4096, 4096>;
+
+TEST_CASE("Thread scratch: Allocations are aligned and bump in order", "[thread_scratch][basic]")
+{
+    small_scratch::reset();
+    small_scratch::scope s;
+
+    REQUIRE(small_scratch::alloc(0) == nullptr);
+
+    auto* a = static_cast<std::byte*>(small_scratch::alloc(10));
+    auto* b = static_cast<std::byte*>(small_scratch::alloc(1));
+    REQUIRE(a != nullptr);
+    REQUIRE(b == a + 16);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+    REQUIRE(small_scratch::get_used() == 32);
+    REQUIRE(small_scratch::get_capacity() >= PAGE_SIZE);
+
+    auto* z = static_cast<unsigned char*>(small_scratch::calloc(64));
+    REQUIRE(z != nullptr);
+    for (size_t i = 0; i < 64; ++i)
+        REQUIRE(z[i] == 0);
+}
+
+TEST_CASE("Thread scratch: Scopes nest and rewind on exit", "[thread_scratch][scope]")
+{
+    small_scratch::reset();
+    small_scratch::scope outer;
+    void* first = small_scratch::alloc(100);
+    const size_t used = small_scratch::get_used();
+
+    void* inner_ptr = nullptr;
+    {
+        small_scratch::scope inner;
+        inner_ptr = small_scratch::alloc(200);
+        REQUIRE(inner_ptr != nullptr);
+        {
+            small_scratch::scope innermost;
+            REQUIRE(small_scratch::alloc(300) != nullptr);
+        }
+        REQUIRE(small_scratch::get_used() == used + 208);
+    }
+    REQUIRE(small_scratch::get_used() == used);
+
+    // LIFO: the next allocation reuses the rewound space
+    REQUIRE(small_scratch::alloc(200) == inner_ptr);
+    REQUIRE(first != inner_ptr);
+}
+
+TEST_CASE("Thread scratch: Grows into new chunks and keeps them across scopes", "[thread_scratch][grow]")
+{
+    small_scratch::reset();
+    small_scratch::trim(0);
+    REQUIRE(small_scratch::get_capacity() == 0);
+
+    {
+        small_scratch::scope s;
+        for (int i = 0; i < 20; ++i)
+        {
+            auto* p = static_cast<char*>(small_scratch::alloc(1000));
+            REQUIRE(p != nullptr);
+            std::memset(p, i, 1000);
+        }
+        // larger than a chunk: gets a chunk of its own
+        void* big = small_scratch::alloc(3 * PAGE_SIZE);
+        REQUIRE(big != nullptr);
+        std::memset(big, 0xAB, 3 * PAGE_SIZE);
+    }
+    REQUIRE(small_scratch::get_used() == 0);
+    const size_t grown = small_scratch::get_capacity();
+    REQUIRE(grown >= 20 * 1000 + 3 * PAGE_SIZE);
+
+    // the same workload again maps nothing new
+    {
+        small_scratch::scope s;
+        for (int i = 0; i < 20; ++i)
+            REQUIRE(small_scratch::alloc(1000) != nullptr);
+        REQUIRE(small_scratch::alloc(3 * PAGE_SIZE) != nullptr);
+    }
+    REQUIRE(small_scratch::get_capacity() == grown);
+}
+
+TEST_CASE("Thread scratch: Trim keeps the retained size and live chunks", "[thread_scratch][trim]")
+{
+    small_scratch::reset();
+    {
+        small_scratch::scope s;
+        for (int i = 0; i < 16; ++i)
+            REQUIRE(small_scratch::alloc(2000) != nullptr);
+    }
+    REQUIRE(small_scratch::get_capacity() > 4096);
+
+    // idle: down to the retained chunk
+    REQUIRE(small_scratch::trim() > 0);
+    REQUIRE(small_scratch::get_capacity() <= 4096);
+
+    // chunks holding live allocations are never unmapped
+    small_scratch::scope s;
+    auto* live = static_cast<char*>(small_scratch::alloc(3000));
+    auto* next = static_cast<char*>(small_scratch::alloc(3000));
+    REQUIRE(live != nullptr);
+    REQUIRE(next != nullptr);
+    std::memset(live, 1, 3000);
+    std::memset(next, 2, 3000);
+    small_scratch::trim(0);
+    REQUIRE(small_scratch::get_capacity() >= 2 * 3000);
+    REQUIRE(live[2999] == 1);
+    REQUIRE(next[2999] == 2);
+}
+
+TEST_CASE("Thread scratch: Every thread has its own arena", "[thread_scratch][threads]")
+{
+    small_scratch::reset();
+    small_scratch::scope s;
+    void* mine = small_scratch::alloc(64);
+    const size_t used = small_scratch::get_used();
+
+    void* theirs = nullptr;
+    size_t their_used = 0;
+    std::thread other([&] {
+        small_scratch::scope t;
+        theirs = small_scratch::alloc(64);
+        their_used = small_scratch::get_used();
+    });
+    other.join();
+
+    REQUIRE(theirs != nullptr);
+    REQUIRE(theirs != mine);
+    REQUIRE(their_used == 64);
+    REQUIRE(small_scratch::get_used() == used);
+}